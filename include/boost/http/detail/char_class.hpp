@@ -0,0 +1,130 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_DETAIL_CHAR_CLASS_HPP
+#define BOOST_HTTP_DETAIL_CHAR_CLASS_HPP
+
+#include <cstddef>
+
+#include <boost/config.hpp>
+
+namespace boost {
+namespace http {
+namespace detail {
+
+/* One bit per character class. Every class check across the library is a
+   single load from `char_class_table` plus an AND. */
+enum char_class {
+    /* tchar          = "!" / "#" / "$" / "%" / "&" / "'" / "*"
+                      / "+" / "-" / "." / "^" / "_" / "`" / "|" / "~"
+                      / DIGIT / ALPHA
+
+       from Section 3.2.6 of RFC7230. */
+    CHAR_TCHAR          = 1 << 0,
+
+    // Bytes accepted within the request-target
+    CHAR_REQUEST_TARGET = 1 << 1,
+
+    /* HTAB / SP / VCHAR / obs-text
+
+       It's the alphabet shared by field-value, reason-phrase and chunk-ext. */
+    CHAR_FIELD_VALUE    = 1 << 2,
+
+    // %x21-7E, from Appendix B of RFC5234
+    CHAR_VCHAR          = 1 << 3,
+
+    // %x80-FF, from Section 3.2.6 of RFC7230
+    CHAR_OBS_TEXT       = 1 << 4,
+
+    // SP / HTAB
+    CHAR_OWS            = 1 << 5,
+
+    // %x30-39
+    CHAR_DIGIT          = 1 << 6,
+
+    // DIGIT / "A"-"F" / "a"-"f"
+    CHAR_HEXDIG         = 1 << 7
+};
+
+/* Class template only so the table can be defined in a header. It's
+   constant-initialized, so there is no dynamic initialization order issue. */
+template<class Dummy>
+struct basic_char_class_table
+{
+    BOOST_ALIGNMENT(64) static const unsigned char data[256];
+};
+
+template<class Dummy>
+BOOST_ALIGNMENT(64)
+const unsigned char basic_char_class_table<Dummy>::data[256] = {
+    /* 0x0_ */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+               0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* 0x1_ */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+               0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* 0x2_ */ 0x24, 0x0F, 0x0C, 0x0D, 0x0F, 0x0F, 0x0F, 0x0F,
+               0x0E, 0x0E, 0x0F, 0x0F, 0x0E, 0x0F, 0x0F, 0x0E,
+    /* 0x3_ */ 0xCF, 0xCF, 0xCF, 0xCF, 0xCF, 0xCF, 0xCF, 0xCF,
+               0xCF, 0xCF, 0x0E, 0x0E, 0x0C, 0x0E, 0x0C, 0x0E,
+    /* 0x4_ */ 0x0E, 0x8F, 0x8F, 0x8F, 0x8F, 0x8F, 0x8F, 0x0F,
+               0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F,
+    /* 0x5_ */ 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F,
+               0x0F, 0x0F, 0x0F, 0x0C, 0x0C, 0x0C, 0x0D, 0x0F,
+    /* 0x6_ */ 0x0D, 0x8F, 0x8F, 0x8F, 0x8F, 0x8F, 0x8F, 0x0F,
+               0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F,
+    /* 0x7_ */ 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F,
+               0x0F, 0x0F, 0x0F, 0x0C, 0x0D, 0x0C, 0x0F, 0x00,
+    /* 0x8_ */ 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+               0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    /* 0x9_ */ 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+               0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    /* 0xA_ */ 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+               0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    /* 0xB_ */ 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+               0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    /* 0xC_ */ 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+               0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    /* 0xD_ */ 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+               0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    /* 0xE_ */ 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+               0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    /* 0xF_ */ 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+               0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14
+};
+
+typedef basic_char_class_table<void> char_class_table;
+
+inline bool in_class(unsigned char c, unsigned cls)
+{
+    return char_class_table::data[c] & cls;
+}
+
+/* Negative values (e.g. from a signed `char`) and values that don't fit in a
+   byte belong to no class. */
+template<class CharT>
+bool in_class(CharT c, unsigned cls)
+{
+    // Negative values wrap around to values greater than 0xFF
+    unsigned long v = static_cast<unsigned long>(c);
+    return v <= 0xFF && (char_class_table::data[v] & cls);
+}
+
+/* Returns the index of the first byte in `[p, p + n)` that doesn't belong to
+   `cls` (or `n` if every byte belongs to `cls`). */
+inline std::size_t find_first_not_of(const unsigned char *p, std::size_t n,
+                                     unsigned cls)
+{
+    for (std::size_t i = 0 ; i != n ; ++i) {
+        if (!(char_class_table::data[p[i]] & cls))
+            return i;
+    }
+    return n;
+}
+
+} // namespace detail
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_DETAIL_CHAR_CLASS_HPP
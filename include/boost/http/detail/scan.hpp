@@ -0,0 +1,465 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_DETAIL_SCAN_HPP
+#define BOOST_HTTP_DETAIL_SCAN_HPP
+
+#include <cstddef>
+
+#include <boost/cstdint.hpp>
+#include <boost/http/detail/char_class.hpp>
+
+#if !defined(BOOST_HTTP_DISABLE_SIMD)                   \
+    && (defined(__GNUC__) || defined(__clang__))        \
+    && (defined(__x86_64__) || defined(__i386__))
+#define BOOST_HTTP_DETAIL_X86_SIMD
+#include <immintrin.h>
+#endif // BOOST_HTTP_DISABLE_SIMD
+
+namespace boost {
+namespace http {
+namespace detail {
+
+/* Character classes understood by the scanners. A scanner returns the number
+   of leading bytes that belong to the class, which is exactly what the
+   byte-by-byte loops of the matchers return. */
+enum scan_class {
+    // field-name and method
+    SCAN_TCHAR,
+    SCAN_REQUEST_TARGET,
+    /* HTAB / SP / VCHAR / obs-text
+
+       field-value, reason-phrase and chunk-ext share this alphabet. */
+    SCAN_FIELD_VALUE,
+    SCAN_CLASS_COUNT
+};
+
+enum scan_level {
+    SCAN_SCALAR,
+    SCAN_SSE2,
+    SCAN_AVX2,
+    SCAN_AVX512BW
+};
+
+struct scan_table
+{
+    /* Nibble lookup (used by the shuffle-based scanners): bit `h` of `lo[l]`
+       is set if the byte `(h << 4) | l` belongs to the class (`h < 8`). */
+    unsigned char lo[16];
+    unsigned char hi[16];
+
+    // Whether all bytes in the `0x80-0xFF` range belong to the class
+    bool obs_text;
+
+    /* Inclusive ASCII ranges (used by the SSE2 scanner, which lacks a byte
+       shuffle instruction) */
+    unsigned char ranges[16][2];
+    unsigned nranges;
+
+    // The `char_class` bit of the class
+    unsigned cls;
+};
+
+// Index of the least significant set bit (`x` must be nonzero)
+inline unsigned ctz64(boost::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    unsigned n = 0;
+    for ( ; !(x & 1) ; x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+inline void build_scan_table(scan_table &t, unsigned cls)
+{
+    for (int i = 0 ; i != 16 ; ++i) {
+        t.lo[i] = 0;
+        t.hi[i] = (i < 8) ? static_cast<unsigned char>(1 << i) : 0;
+    }
+    t.nranges = 0;
+    t.cls = cls;
+
+    for (int c = 0 ; c != 0x80 ; ++c) {
+        if (!in_class(static_cast<unsigned char>(c), cls))
+            continue;
+
+        t.lo[c & 0x0F] |= static_cast<unsigned char>(1 << (c >> 4));
+
+        if (c != 0 && in_class(static_cast<unsigned char>(c - 1), cls)) {
+            t.ranges[t.nranges - 1][1] = static_cast<unsigned char>(c);
+        } else {
+            t.ranges[t.nranges][0] = static_cast<unsigned char>(c);
+            t.ranges[t.nranges][1] = static_cast<unsigned char>(c);
+            ++t.nranges;
+        }
+    }
+
+    t.obs_text = in_class(static_cast<unsigned char>(0x80), cls);
+}
+
+inline std::size_t scan_scalar(const unsigned char *p, std::size_t n,
+                               const scan_table &t)
+{
+    return find_first_not_of(p, n, t.cls);
+}
+
+/* The `scan_mask_*` family classifies up to 64 bytes at once and returns a
+   bitmask where bit `i` is set if `p[i]` does *not* belong to the class. */
+inline boost::uint64_t scan_mask_scalar(const unsigned char *p, std::size_t n,
+                                        const scan_table &t)
+{
+    boost::uint64_t mask = 0;
+    for (std::size_t i = 0 ; i != n ; ++i) {
+        if (!in_class(p[i], t.cls))
+            mask |= boost::uint64_t(1) << i;
+    }
+    return mask;
+}
+
+#ifdef BOOST_HTTP_DETAIL_X86_SIMD
+
+__attribute__((target("sse2")))
+inline std::size_t scan_sse2(const unsigned char *p, std::size_t n,
+                             const scan_table &t)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i first[16];
+    __m128i width[16];
+    std::size_t i = 0;
+
+    for (unsigned r = 0 ; r != t.nranges ; ++r) {
+        first[r] = _mm_set1_epi8(t.ranges[r][0]);
+        width[r] = _mm_set1_epi8(t.ranges[r][1] - t.ranges[r][0]);
+    }
+
+    for ( ; n - i >= 16 ; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i in = t.obs_text ? _mm_cmplt_epi8(v, zero) : zero;
+
+        for (unsigned r = 0 ; r != t.nranges ; ++r) {
+            // (v - first) <= (last - first), as unsigned bytes
+            __m128i x = _mm_sub_epi8(v, first[r]);
+            x = _mm_cmpeq_epi8(_mm_min_epu8(x, width[r]), x);
+            in = _mm_or_si128(in, x);
+        }
+
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(in)) & 0xFFFF;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    return i + scan_scalar(p + i, n - i, t);
+}
+
+__attribute__((target("sse2")))
+inline boost::uint64_t scan_mask_sse2(const unsigned char *p, std::size_t n,
+                                      const scan_table &t)
+{
+    const __m128i zero = _mm_setzero_si128();
+    boost::uint64_t mask = 0;
+    std::size_t i = 0;
+
+    for ( ; n - i >= 16 ; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i in = t.obs_text ? _mm_cmplt_epi8(v, zero) : zero;
+
+        for (unsigned r = 0 ; r != t.nranges ; ++r) {
+            __m128i x = _mm_sub_epi8(v, _mm_set1_epi8(t.ranges[r][0]));
+            __m128i width = _mm_set1_epi8(t.ranges[r][1] - t.ranges[r][0]);
+            x = _mm_cmpeq_epi8(_mm_min_epu8(x, width), x);
+            in = _mm_or_si128(in, x);
+        }
+
+        boost::uint64_t m = ~static_cast<unsigned>(_mm_movemask_epi8(in))
+            & 0xFFFF;
+        mask |= m << i;
+    }
+
+    if (i != n)
+        mask |= scan_mask_scalar(p + i, n - i, t) << i;
+
+    return mask;
+}
+
+__attribute__((target("avx2")))
+inline std::size_t scan_avx2(const unsigned char *p, std::size_t n,
+                             const scan_table &t)
+{
+    const __m256i lo_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(t.lo)));
+    const __m256i hi_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(t.hi)));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t i = 0;
+
+    for ( ; n - i >= 32 ; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i lo = _mm256_and_si256(v, nibble);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        __m256i bits = _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo),
+                                        _mm256_shuffle_epi8(hi_table, hi));
+        __m256i out = _mm256_cmpeq_epi8(bits, zero);
+
+        if (t.obs_text)
+            out = _mm256_andnot_si256(_mm256_cmpgt_epi8(zero, v), out);
+
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(out));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    return i + scan_scalar(p + i, n - i, t);
+}
+
+__attribute__((target("avx2")))
+inline boost::uint64_t scan_mask_avx2(const unsigned char *p, std::size_t n,
+                                      const scan_table &t)
+{
+    const __m256i lo_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(t.lo)));
+    const __m256i hi_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(t.hi)));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    boost::uint64_t mask = 0;
+    std::size_t i = 0;
+
+    for ( ; n - i >= 32 ; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i lo = _mm256_and_si256(v, nibble);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        __m256i bits = _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo),
+                                        _mm256_shuffle_epi8(hi_table, hi));
+        __m256i out = _mm256_cmpeq_epi8(bits, zero);
+
+        if (t.obs_text)
+            out = _mm256_andnot_si256(_mm256_cmpgt_epi8(zero, v), out);
+
+        boost::uint64_t m = static_cast<boost::uint32_t>
+            (_mm256_movemask_epi8(out));
+        mask |= m << i;
+    }
+
+    if (i != n)
+        mask |= scan_mask_scalar(p + i, n - i, t) << i;
+
+    return mask;
+}
+
+/* The 16 bytes of `table` in every lane. The zero-masked form is used as the
+   plain one reads an undefined source register (GCC warns about it). */
+__attribute__((target("avx512f,avx512bw")))
+inline __m512i broadcast_avx512bw(const unsigned char *table)
+{
+    return _mm512_maskz_broadcast_i32x4(
+        __mmask16(0xFFFF),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+/* Loads the bytes of `p` selected by `valid`, the others are zero. Full blocks
+   take an unmasked load and the tail a masked load over a zeroed source
+   (masked-out bytes are never touched, so the tail needs no scalar loop). */
+__attribute__((target("avx512f,avx512bw")))
+inline __m512i load_avx512bw(const unsigned char *p, __mmask64 valid)
+{
+    if (valid == ~__mmask64(0))
+        return _mm512_loadu_si512(p);
+
+    return _mm512_mask_loadu_epi8(_mm512_setzero_si512(), valid, p);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+inline std::size_t scan_avx512bw(const unsigned char *p, std::size_t n,
+                                 const scan_table &t)
+{
+    const __m512i lo_table = broadcast_avx512bw(t.lo);
+    const __m512i hi_table = broadcast_avx512bw(t.hi);
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    std::size_t i = 0;
+
+    for ( ; i != n ; ) {
+        std::size_t remaining = n - i;
+        __mmask64 valid = (remaining >= 64)
+            ? ~__mmask64(0) : (__mmask64(1) << remaining) - 1;
+
+        __m512i v = load_avx512bw(p + i, valid);
+        __m512i lo = _mm512_and_si512(v, nibble);
+        __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble);
+        __m512i bits = _mm512_and_si512(_mm512_shuffle_epi8(lo_table, lo),
+                                        _mm512_shuffle_epi8(hi_table, hi));
+        __mmask64 in = _mm512_test_epi8_mask(bits, bits);
+
+        if (t.obs_text)
+            in |= _mm512_movepi8_mask(v);
+
+        __mmask64 out = ~in & valid;
+        if (out)
+            return i + __builtin_ctzll(out);
+
+        i += (remaining >= 64) ? 64 : remaining;
+    }
+
+    return n;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+inline boost::uint64_t scan_mask_avx512bw(const unsigned char *p,
+                                          std::size_t n, const scan_table &t)
+{
+    const __m512i lo_table = broadcast_avx512bw(t.lo);
+    const __m512i hi_table = broadcast_avx512bw(t.hi);
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    __mmask64 valid = (n >= 64) ? ~__mmask64(0) : (__mmask64(1) << n) - 1;
+
+    __m512i v = load_avx512bw(p, valid);
+    __m512i lo = _mm512_and_si512(v, nibble);
+    __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble);
+    __m512i bits = _mm512_and_si512(_mm512_shuffle_epi8(lo_table, lo),
+                                    _mm512_shuffle_epi8(hi_table, hi));
+    __mmask64 in = _mm512_test_epi8_mask(bits, bits);
+
+    if (t.obs_text)
+        in |= _mm512_movepi8_mask(v);
+
+    return ~in & valid;
+}
+
+#endif // BOOST_HTTP_DETAIL_X86_SIMD
+
+// Best scanner supported by the running CPU
+inline scan_level detect_scan_level()
+{
+#ifdef BOOST_HTTP_DETAIL_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw"))
+        return SCAN_AVX512BW;
+    if (__builtin_cpu_supports("avx2"))
+        return SCAN_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SCAN_SSE2;
+#endif // BOOST_HTTP_DETAIL_X86_SIMD
+    return SCAN_SCALAR;
+}
+
+struct scan_context
+{
+    typedef std::size_t (*scanner)(const unsigned char*, std::size_t,
+                                   const scan_table&);
+    typedef boost::uint64_t (*mask_scanner)(const unsigned char*, std::size_t,
+                                            const scan_table&);
+
+    scan_context()
+        : level(detect_scan_level())
+    {
+        build_scan_table(tables[SCAN_TCHAR], CHAR_TCHAR);
+        build_scan_table(tables[SCAN_REQUEST_TARGET], CHAR_REQUEST_TARGET);
+        build_scan_table(tables[SCAN_FIELD_VALUE], CHAR_FIELD_VALUE);
+
+        for (int i = 0 ; i != SCAN_CLASS_COUNT ; ++i) {
+            fn[i] = get_scanner(level);
+            mask_fn[i] = get_mask_scanner(level);
+
+            /* Each range costs four instructions per vector in the SSE2
+               scanner and it only beats the scalar loop on the simpler
+               classes. */
+            if (level == SCAN_SSE2 && tables[i].nranges > 4) {
+                fn[i] = scan_scalar;
+                mask_fn[i] = scan_mask_scalar;
+            }
+        }
+    }
+
+    static scanner get_scanner(scan_level level)
+    {
+        switch (level) {
+#ifdef BOOST_HTTP_DETAIL_X86_SIMD
+        case SCAN_AVX512BW:
+            return scan_avx512bw;
+        case SCAN_AVX2:
+            return scan_avx2;
+        case SCAN_SSE2:
+            return scan_sse2;
+#endif // BOOST_HTTP_DETAIL_X86_SIMD
+        default:
+            return scan_scalar;
+        }
+    }
+
+    static mask_scanner get_mask_scanner(scan_level level)
+    {
+        switch (level) {
+#ifdef BOOST_HTTP_DETAIL_X86_SIMD
+        case SCAN_AVX512BW:
+            return scan_mask_avx512bw;
+        case SCAN_AVX2:
+            return scan_mask_avx2;
+        case SCAN_SSE2:
+            return scan_mask_sse2;
+#endif // BOOST_HTTP_DETAIL_X86_SIMD
+        default:
+            return scan_mask_scalar;
+        }
+    }
+
+    // Dispatch is resolved only once, at the first scan
+    static const scan_context &get()
+    {
+        static const scan_context ctx;
+        return ctx;
+    }
+
+    scan_level level;
+    scanner fn[SCAN_CLASS_COUNT];
+    mask_scanner mask_fn[SCAN_CLASS_COUNT];
+    scan_table tables[SCAN_CLASS_COUNT];
+};
+
+/* Returns the number of leading bytes in `[p, p + n)` that belong to `cls`
+   using the best scanner available. Short inputs are handled inline as the
+   indirect call wouldn't pay off. */
+inline std::size_t scan(scan_class cls, const unsigned char *p, std::size_t n)
+{
+    const scan_context &ctx = scan_context::get();
+    const scan_table &t = ctx.tables[cls];
+
+    if (n < 16)
+        return scan_scalar(p, n, t);
+
+    return ctx.fn[cls](p, n, t);
+}
+
+// Same as `scan`, but forces the implementation (tests and benchmarks)
+inline std::size_t scan(scan_level level, scan_class cls,
+                        const unsigned char *p, std::size_t n)
+{
+    const scan_context &ctx = scan_context::get();
+    return scan_context::get_scanner(level)(p, n, ctx.tables[cls]);
+}
+
+// Classifies `n <= 64` bytes (see `scan_mask_scalar`)
+inline boost::uint64_t scan_mask(scan_class cls, const unsigned char *p,
+                                 std::size_t n)
+{
+    const scan_context &ctx = scan_context::get();
+    return ctx.mask_fn[cls](p, n, ctx.tables[cls]);
+}
+
+inline boost::uint64_t scan_mask(scan_level level, scan_class cls,
+                                 const unsigned char *p, std::size_t n)
+{
+    const scan_context &ctx = scan_context::get();
+    return scan_context::get_mask_scanner(level)(p, n, ctx.tables[cls]);
+}
+
+} // namespace detail
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_DETAIL_SCAN_HPP
@@ -0,0 +1,114 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_FIELD_NAME_ID_HPP
+#define BOOST_HTTP_FIELD_NAME_ID_HPP
+
+#include <boost/utility/string_view.hpp>
+#include <boost/cstdint.hpp>
+
+namespace boost {
+namespace http {
+
+/* Identifiers for the field names registered at IANA's "Message Headers"
+   registry which are relevant to HTTP. Any other field name is `unknown`. */
+struct field_name_id
+{
+    enum value
+    {
+        unknown,
+        accept,
+        accept_charset,
+        accept_encoding,
+        accept_language,
+        accept_patch,
+        accept_ranges,
+        access_control_allow_credentials,
+        access_control_allow_headers,
+        access_control_allow_methods,
+        access_control_allow_origin,
+        access_control_expose_headers,
+        access_control_max_age,
+        access_control_request_headers,
+        access_control_request_method,
+        age,
+        allow,
+        alt_svc,
+        authentication_info,
+        authorization,
+        cache_control,
+        connection,
+        content_disposition,
+        content_encoding,
+        content_language,
+        content_length,
+        content_location,
+        content_md5,
+        content_range,
+        content_security_policy,
+        content_type,
+        cookie,
+        date,
+        etag,
+        expect,
+        expires,
+        forwarded,
+        from,
+        host,
+        if_match,
+        if_modified_since,
+        if_none_match,
+        if_range,
+        if_unmodified_since,
+        keep_alive,
+        last_modified,
+        link,
+        location,
+        max_forwards,
+        origin,
+        pragma,
+        prefer,
+        preference_applied,
+        proxy_authenticate,
+        proxy_authentication_info,
+        proxy_authorization,
+        range,
+        referer,
+        retry_after,
+        sec_websocket_accept,
+        sec_websocket_extensions,
+        sec_websocket_key,
+        sec_websocket_protocol,
+        sec_websocket_version,
+        server,
+        set_cookie,
+        strict_transport_security,
+        te,
+        trailer,
+        transfer_encoding,
+        upgrade,
+        user_agent,
+        vary,
+        via,
+        warning,
+        www_authenticate,
+        x_frame_options
+    };
+
+    /* Case-insensitive classification of `name`. It costs one hash computation
+       and at most one comparison. */
+    static value classify(boost::string_view name);
+
+    // Lowercase spelling of `v` (empty for `unknown`)
+    static boost::string_view name(value v);
+};
+
+} // namespace http
+} // namespace boost
+
+#include "field_name_id.ipp"
+
+#endif // BOOST_HTTP_FIELD_NAME_ID_HPP
@@ -0,0 +1,160 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+
+namespace detail {
+
+// Indexed by `field_name_id::value`
+inline const char *const *field_name_id_names()
+{
+    static const char *const names[] = {
+        "",
+        "accept",
+        "accept-charset",
+        "accept-encoding",
+        "accept-language",
+        "accept-patch",
+        "accept-ranges",
+        "access-control-allow-credentials",
+        "access-control-allow-headers",
+        "access-control-allow-methods",
+        "access-control-allow-origin",
+        "access-control-expose-headers",
+        "access-control-max-age",
+        "access-control-request-headers",
+        "access-control-request-method",
+        "age",
+        "allow",
+        "alt-svc",
+        "authentication-info",
+        "authorization",
+        "cache-control",
+        "connection",
+        "content-disposition",
+        "content-encoding",
+        "content-language",
+        "content-length",
+        "content-location",
+        "content-md5",
+        "content-range",
+        "content-security-policy",
+        "content-type",
+        "cookie",
+        "date",
+        "etag",
+        "expect",
+        "expires",
+        "forwarded",
+        "from",
+        "host",
+        "if-match",
+        "if-modified-since",
+        "if-none-match",
+        "if-range",
+        "if-unmodified-since",
+        "keep-alive",
+        "last-modified",
+        "link",
+        "location",
+        "max-forwards",
+        "origin",
+        "pragma",
+        "prefer",
+        "preference-applied",
+        "proxy-authenticate",
+        "proxy-authentication-info",
+        "proxy-authorization",
+        "range",
+        "referer",
+        "retry-after",
+        "sec-websocket-accept",
+        "sec-websocket-extensions",
+        "sec-websocket-key",
+        "sec-websocket-protocol",
+        "sec-websocket-version",
+        "server",
+        "set-cookie",
+        "strict-transport-security",
+        "te",
+        "trailer",
+        "transfer-encoding",
+        "upgrade",
+        "user-agent",
+        "vary",
+        "via",
+        "warning",
+        "www-authenticate",
+        "x-frame-options"
+    };
+    return names;
+}
+
+} // namespace detail
+
+inline field_name_id::value field_name_id::classify(boost::string_view name)
+{
+    /* Perfect hash generated offline (gperf-style) for the names listed in
+       `field_name_id::value`: the length and three lowercased key bytes are
+       mixed together and the top 8 bits of the product index `slots`. The
+       `| 0x20` lowercasing is only good enough for hashing, the final
+       comparison is exact. */
+    static const unsigned char slots[256] = {
+        39, 30,  0, 19,  0,  0, 56,  0,  0, 44,  0,  0, 72,  0, 50,  0,
+         0, 55,  0, 18,  5,  0, 32,  0,  0, 47, 68,  0,  0,  0, 10,  0,
+        33,  0,  0,  0, 61, 43,  0,  0, 26,  0,  0,  0, 54, 20,  0,  0,
+        17,  0,  0,  0,  0, 40,  0,  0,  0,  0, 24, 53,  0,  0, 13,  0,
+         0, 69,  0, 15,  0,  0, 35,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0, 41,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 76, 27,
+        28,  0,  0,  0,  0, 62,  0, 75,  0, 34,  0,  0,  0, 29,  0,  0,
+         0,  0,  0,  0,  0,  2,  0, 42,  0,  0, 59,  0, 46,  0,  0,  0,
+         0,  0,  0,  0, 22,  0,  0,  3, 45, 67,  0, 16,  0,  0,  0, 66,
+         0,  0,  8,  7, 52,  0, 12,  0,  0,  0, 49,  0,  0,  0, 64, 38,
+        74,  0,  0,  0, 14,  0, 60,  0, 65,  0,  0,  0,  0,  0,  0,  0,
+        36, 70,  0, 58,  0,  0,  0,  0,  0,  0,  0,  0,  6,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0, 63,  0,  0,  0,  0,  0,  0,  0,
+         0,  0, 51,  0,  4,  0,  0,  0,  0,  0,  0,  0, 73,  0,  0,  0,
+         0, 25,  0,  0, 48,  0,  0,  0,  0, 21,  0, 57,  0,  0, 23,  0,
+         9, 31,  0,  0,  0,  0,  0,  0,  1, 37,  0,  0,  0, 71, 11,  0
+    };
+
+    std::size_t n = name.size();
+    if (n < 2 || n > 32)
+        return unknown;
+
+    const unsigned char *s = reinterpret_cast<const unsigned char*>(name.data());
+    boost::uint_least32_t x = boost::uint_least32_t(n) * 101u
+        + (s[0] | 0x20u) * 199u + (s[n - 2] | 0x20u) * 73u
+        + (s[n / 2] | 0x20u) * 172u;
+    x = (x * 2654435761u) & 0xFFFFFFFFu;
+
+    value ret = static_cast<value>(slots[x >> 24]);
+    if (ret == unknown)
+        return unknown;
+
+    const char *candidate = detail::field_name_id_names()[ret];
+
+    for (std::size_t i = 0 ; i != n ; ++i) {
+        unsigned char c = s[i];
+        if (c >= 'A' && c <= 'Z')
+            c |= 0x20;
+
+        if (candidate[i] == '\0'
+            || c != static_cast<unsigned char>(candidate[i])) {
+            return unknown;
+        }
+    }
+
+    return (candidate[n] == '\0') ? ret : unknown;
+}
+
+inline boost::string_view field_name_id::name(value v)
+{
+    return detail::field_name_id_names()[v];
+}
+
+} // namespace http
+} // namespace boost
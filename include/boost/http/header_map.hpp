@@ -0,0 +1,123 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_HEADER_MAP_HPP
+#define BOOST_HTTP_HEADER_MAP_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/utility/string_view.hpp>
+#include <boost/http/token.hpp>
+
+namespace boost {
+namespace http {
+
+/* An owned copy of the header fields of a message, for messages that must
+   outlive the buffer they were read from. Names and values are packed into a
+   single arena and indexed by an open-addressing table keyed by a
+   case-insensitive hash of the name. Fields keep their order and duplicates
+   are kept as separate fields, chained by name.
+
+   `clear()` keeps every buffer, so a map reused message after message stops
+   allocating once it has seen the largest header block. */
+class header_map
+{
+public:
+    typedef std::size_t size_type;
+    typedef boost::string_view view_type;
+
+    header_map();
+
+    // Reserves room for `nfields` fields holding `nbytes` bytes
+    header_map(size_type nfields, size_type nbytes);
+
+    // Forgets every field (memory is kept)
+    void clear();
+
+    size_type size() const;
+    bool empty() const;
+
+    // The `i`-th field in insertion order
+    view_type name(size_type i) const;
+    view_type value(size_type i) const;
+
+    // Appends a copy of the field
+    void insert(view_type name, view_type value);
+
+    /* Inserts the header field that `reader` is going through: call it for
+       every `field_name` and `field_value` token (other tokens are ignored).
+       The pieces of a split value are joined. */
+    template<class Reader>
+    void record(const Reader &reader);
+
+    /* Position of the first field called `name` (case-insensitive), or
+       `size()` if there is none. */
+    size_type find(view_type name) const;
+
+    /* Position of the next field with the same name as the `i`-th one, or
+       `size()` if there is none. */
+    size_type find_next(size_type i) const;
+
+    size_type count(view_type name) const;
+
+    // Value of the first field called `name` (empty if there is none)
+    view_type get(view_type name) const;
+
+private:
+    enum {
+        // `next` of the last field of a name and `last` of the other ones
+        NONE = 0xFFFFFFFF,
+        INITIAL_TABLE_SIZE = 16
+    };
+
+    struct field
+    {
+        boost::uint32_t name_offset;
+        boost::uint32_t name_size;
+        boost::uint32_t value_offset;
+        boost::uint32_t value_size;
+        boost::uint32_t hash;
+        // Next field with the same name
+        boost::uint32_t next;
+        // Last field with the same name (only kept by the first one)
+        boost::uint32_t last;
+    };
+
+    static boost::uint32_t hash(view_type name);
+    static bool iequals(view_type a, view_type b);
+
+    boost::uint32_t append(view_type bytes);
+    view_type at(boost::uint32_t offset, boost::uint32_t size) const;
+
+    // Adds the field just pushed into `fields` to `table`
+    void link(boost::uint32_t i);
+    void grow_table();
+
+    std::vector<char> arena;
+    std::vector<field> fields;
+
+    /* Position + 1 of the first field of each name (0 marks an empty slot).
+       Its size is a power of 2 kept at least twice the number of names. */
+    std::vector<boost::uint32_t> table;
+    size_type nnames;
+
+    // Name received by `record()` whose value is yet to come
+    boost::uint32_t pending_offset;
+    boost::uint32_t pending_size;
+    // Start of the value being received in pieces (`NONE` if none)
+    boost::uint32_t pending_value;
+};
+
+} // namespace http
+} // namespace boost
+
+#include "header_map.ipp"
+
+#endif // BOOST_HTTP_HEADER_MAP_HPP
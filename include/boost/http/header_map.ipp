@@ -0,0 +1,241 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+
+inline header_map::header_map()
+    : table(INITIAL_TABLE_SIZE, 0)
+    , nnames(0)
+    , pending_offset(0)
+    , pending_size(0)
+    , pending_value(NONE)
+{}
+
+inline header_map::header_map(size_type nfields, size_type nbytes)
+    : table(INITIAL_TABLE_SIZE, 0)
+    , nnames(0)
+    , pending_offset(0)
+    , pending_size(0)
+    , pending_value(NONE)
+{
+    arena.reserve(nbytes);
+    fields.reserve(nfields);
+
+    while (table.size() < 2 * nfields)
+        table.resize(table.size() * 2, 0);
+}
+
+inline void header_map::clear()
+{
+    arena.clear();
+    fields.clear();
+    std::fill(table.begin(), table.end(), 0);
+    nnames = 0;
+    pending_offset = 0;
+    pending_size = 0;
+    pending_value = NONE;
+}
+
+inline header_map::size_type header_map::size() const
+{
+    return fields.size();
+}
+
+inline bool header_map::empty() const
+{
+    return fields.empty();
+}
+
+inline header_map::view_type header_map::name(size_type i) const
+{
+    return at(fields[i].name_offset, fields[i].name_size);
+}
+
+inline header_map::view_type header_map::value(size_type i) const
+{
+    return at(fields[i].value_offset, fields[i].value_size);
+}
+
+inline void header_map::insert(view_type name, view_type value)
+{
+    field f;
+    f.name_offset = append(name);
+    f.name_size = boost::uint32_t(name.size());
+    f.value_offset = append(value);
+    f.value_size = boost::uint32_t(value.size());
+    f.hash = hash(name);
+    f.next = NONE;
+    f.last = NONE;
+
+    fields.push_back(f);
+    link(boost::uint32_t(fields.size() - 1));
+}
+
+template<class Reader>
+void header_map::record(const Reader &reader)
+{
+    switch (reader.code()) {
+    case token::code::field_name:
+        {
+            view_type name = reader.template value<token::field_name>();
+            pending_offset = append(name);
+            pending_size = boost::uint32_t(name.size());
+        }
+        break;
+    case token::code::field_value:
+        {
+            view_type value = reader.template value<token::field_value>();
+            boost::uint32_t offset = append(value);
+            if (pending_value == NONE)
+                pending_value = offset;
+
+            if (!reader.final_piece())
+                break;
+
+            field f;
+            f.name_offset = pending_offset;
+            f.name_size = pending_size;
+            f.value_offset = pending_value;
+            f.value_size = boost::uint32_t(arena.size() - pending_value);
+            pending_value = NONE;
+            f.hash = hash(at(pending_offset, pending_size));
+            f.next = NONE;
+            f.last = NONE;
+
+            fields.push_back(f);
+            link(boost::uint32_t(fields.size() - 1));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+inline header_map::size_type header_map::find(view_type name) const
+{
+    boost::uint32_t h = hash(name);
+    size_type mask = table.size() - 1;
+
+    for (size_type pos = h & mask ; table[pos] != 0 ; pos = (pos + 1) & mask) {
+        const field &f = fields[table[pos] - 1];
+        if (f.hash == h && iequals(at(f.name_offset, f.name_size), name))
+            return table[pos] - 1;
+    }
+
+    return size();
+}
+
+inline header_map::size_type header_map::find_next(size_type i) const
+{
+    return (fields[i].next == NONE) ? size() : fields[i].next;
+}
+
+inline header_map::size_type header_map::count(view_type name) const
+{
+    size_type ret = 0;
+    for (size_type i = find(name) ; i != size() ; i = find_next(i))
+        ++ret;
+    return ret;
+}
+
+inline header_map::view_type header_map::get(view_type name) const
+{
+    size_type i = find(name);
+    return (i == size()) ? view_type() : value(i);
+}
+
+inline boost::uint32_t header_map::hash(view_type name)
+{
+    /* FNV-1a. The `| 0x20` lowercasing is only good enough for hashing, the
+       final comparison is exact. */
+    boost::uint32_t ret = 2166136261u;
+    for (std::size_t i = 0 ; i != name.size() ; ++i) {
+        ret ^= static_cast<unsigned char>(name[i]) | 0x20u;
+        ret = (ret * 16777619u) & 0xFFFFFFFFu;
+    }
+    return ret;
+}
+
+inline bool header_map::iequals(view_type a, view_type b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    // Field names are case-insensitive ASCII (section 3.2 of RFC7230)
+    for (std::size_t i = 0 ; i != a.size() ; ++i) {
+        unsigned char x = a[i];
+        unsigned char y = b[i];
+        if (x >= 'A' && x <= 'Z')
+            x |= 0x20;
+        if (y >= 'A' && y <= 'Z')
+            y |= 0x20;
+        if (x != y)
+            return false;
+    }
+
+    return true;
+}
+
+inline boost::uint32_t header_map::append(view_type bytes)
+{
+    assert(arena.size() + bytes.size() < NONE);
+    boost::uint32_t ret = boost::uint32_t(arena.size());
+    arena.insert(arena.end(), bytes.begin(), bytes.end());
+    return ret;
+}
+
+inline header_map::view_type header_map::at(boost::uint32_t offset,
+                                            boost::uint32_t size) const
+{
+    if (size == 0)
+        return view_type();
+
+    return view_type(&arena[offset], size);
+}
+
+inline void header_map::link(boost::uint32_t i)
+{
+    field &f = fields[i];
+    size_type mask = table.size() - 1;
+    size_type pos = f.hash & mask;
+
+    for ( ; table[pos] != 0 ; pos = (pos + 1) & mask) {
+        field &head = fields[table[pos] - 1];
+        if (head.hash == f.hash
+            && iequals(at(head.name_offset, head.name_size),
+                       at(f.name_offset, f.name_size))) {
+            fields[head.last].next = i;
+            head.last = i;
+            return;
+        }
+    }
+
+    table[pos] = i + 1;
+    f.last = i;
+
+    if (2 * ++nnames > table.size())
+        grow_table();
+}
+
+inline void header_map::grow_table()
+{
+    table.assign(table.size() * 2, 0);
+    size_type mask = table.size() - 1;
+
+    for (boost::uint32_t i = 0 ; i != fields.size() ; ++i) {
+        // Only the first field of each name has `last` set
+        if (fields[i].last == NONE)
+            continue;
+
+        size_type pos = fields[i].hash & mask;
+        while (table[pos] != 0)
+            pos = (pos + 1) & mask;
+        table[pos] = i + 1;
+    }
+}
+
+} // namespace http
+} // namespace boost
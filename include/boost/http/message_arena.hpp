@@ -0,0 +1,138 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_MESSAGE_ARENA_HPP
+#define BOOST_HTTP_MESSAGE_ARENA_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+#include <boost/config.hpp>
+#include <boost/container/pmr/memory_resource.hpp>
+
+namespace boost {
+namespace http {
+
+namespace detail {
+
+// Header of every block. The usable bytes follow it.
+struct arena_block
+{
+    arena_block *next;
+    std::size_t size;
+};
+
+} // namespace detail
+
+class message_arena;
+
+/* Fixed-size blocks for `message_arena`s. Blocks given back by an arena are
+   kept for the next ones, so a busy thread stops calling `operator new` once
+   it reaches its peak. It isn't thread-safe: use one pool per thread (e.g. one
+   per `io_context` run by a single thread). */
+class arena_block_pool
+{
+public:
+    typedef std::size_t size_type;
+
+    /* Blocks have `block_size` usable bytes. At most `max_cached` free blocks
+       are kept. Extra ones are deleted. */
+    explicit arena_block_pool(size_type block_size = 4096,
+                              size_type max_cached = 64);
+
+    ~arena_block_pool();
+
+    size_type block_size() const;
+
+    // Number of free blocks kept for reuse
+    size_type cached() const;
+
+private:
+    friend class message_arena;
+
+    // Not copyable
+    arena_block_pool(const arena_block_pool&);
+    arena_block_pool &operator=(const arena_block_pool&);
+
+    static detail::arena_block *new_block(size_type size);
+    static void delete_block(detail::arena_block *block);
+
+    detail::arena_block *acquire();
+
+    // Takes the `n` blocks from `head` to `tail` (chained by `next`)
+    void release(detail::arena_block *head, detail::arena_block *tail,
+                 size_type n);
+
+    size_type block_size_;
+    size_type max_cached;
+
+    detail::arena_block *free_list;
+    size_type nfree;
+};
+
+/* A monotonic memory resource for everything an application builds out of one
+   message (copied header values, decoded targets, owned message objects...).
+   Deallocation is a no-op. The memory is released all at once by `release()`,
+   which is meant to be called at `token::code::end_of_message`.
+
+   It's a `boost::container::pmr::memory_resource`, so it plugs into
+   `pmr::polymorphic_allocator` and the `boost::container::pmr` containers. */
+class message_arena: public boost::container::pmr::memory_resource
+{
+public:
+    typedef std::size_t size_type;
+
+    // `pool` must outlive this object
+    explicit message_arena(arena_block_pool &pool);
+
+    ~message_arena();
+
+    /* Gives every block back to the pool. It takes constant time unless
+       allocations larger than a block were made (these are deleted one by
+       one). */
+    void release();
+
+    // Bytes handed out since the last `release()` (padding included)
+    size_type used() const;
+
+protected:
+    virtual void *do_allocate(std::size_t bytes, std::size_t alignment);
+    virtual void do_deallocate(void *p, std::size_t bytes,
+                               std::size_t alignment);
+    virtual bool do_is_equal(const boost::container::pmr::memory_resource &o)
+        const BOOST_NOEXCEPT;
+
+private:
+    // Not copyable
+    message_arena(const message_arena&);
+    message_arena &operator=(const message_arena&);
+
+    static char *payload(detail::arena_block *block);
+
+    arena_block_pool &pool;
+
+    // Blocks from `pool`, the current one first
+    detail::arena_block *blocks;
+    detail::arena_block *last_block;
+    size_type nblocks;
+
+    // Allocations too large for a block
+    detail::arena_block *large_blocks;
+
+    // Free space of the current block
+    char *cur;
+    char *end;
+
+    size_type used_;
+};
+
+} // namespace http
+} // namespace boost
+
+#include "message_arena.ipp"
+
+#endif // BOOST_HTTP_MESSAGE_ARENA_HPP
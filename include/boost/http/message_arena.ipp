@@ -0,0 +1,189 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+
+namespace detail {
+
+// Usable bytes start this far from the block (keeps them suitably aligned)
+static const std::size_t arena_header_size
+    = (sizeof(arena_block) + 15) & ~std::size_t(15);
+
+} // namespace detail
+
+inline arena_block_pool::arena_block_pool(size_type block_size,
+                                          size_type max_cached)
+    : block_size_(block_size)
+    , max_cached(max_cached)
+    , free_list(NULL)
+    , nfree(0)
+{}
+
+inline arena_block_pool::~arena_block_pool()
+{
+    while (free_list) {
+        detail::arena_block *next = free_list->next;
+        delete_block(free_list);
+        free_list = next;
+    }
+}
+
+inline arena_block_pool::size_type arena_block_pool::block_size() const
+{
+    return block_size_;
+}
+
+inline arena_block_pool::size_type arena_block_pool::cached() const
+{
+    return nfree;
+}
+
+inline detail::arena_block *arena_block_pool::new_block(size_type size)
+{
+    void *mem = ::operator new(detail::arena_header_size + size);
+    detail::arena_block *ret = static_cast<detail::arena_block*>(mem);
+    ret->next = NULL;
+    ret->size = size;
+    return ret;
+}
+
+inline void arena_block_pool::delete_block(detail::arena_block *block)
+{
+    ::operator delete(static_cast<void*>(block));
+}
+
+inline detail::arena_block *arena_block_pool::acquire()
+{
+    if (!free_list)
+        return new_block(block_size_);
+
+    detail::arena_block *ret = free_list;
+    free_list = ret->next;
+    --nfree;
+    ret->next = NULL;
+    return ret;
+}
+
+inline void arena_block_pool::release(detail::arena_block *head,
+                                      detail::arena_block *tail, size_type n)
+{
+    tail->next = free_list;
+    free_list = head;
+    nfree += n;
+
+    while (nfree > max_cached) {
+        detail::arena_block *next = free_list->next;
+        delete_block(free_list);
+        free_list = next;
+        --nfree;
+    }
+}
+
+inline message_arena::message_arena(arena_block_pool &pool)
+    : pool(pool)
+    , blocks(NULL)
+    , last_block(NULL)
+    , nblocks(0)
+    , large_blocks(NULL)
+    , cur(NULL)
+    , end(NULL)
+    , used_(0)
+{}
+
+inline message_arena::~message_arena()
+{
+    release();
+}
+
+inline void message_arena::release()
+{
+    if (blocks)
+        pool.release(blocks, last_block, nblocks);
+
+    while (large_blocks) {
+        detail::arena_block *next = large_blocks->next;
+        arena_block_pool::delete_block(large_blocks);
+        large_blocks = next;
+    }
+
+    blocks = NULL;
+    last_block = NULL;
+    nblocks = 0;
+    cur = NULL;
+    end = NULL;
+    used_ = 0;
+}
+
+inline message_arena::size_type message_arena::used() const
+{
+    return used_;
+}
+
+inline void *message_arena::do_allocate(std::size_t bytes,
+                                        std::size_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    std::size_t misalignment
+        = reinterpret_cast<std::size_t>(cur) & (alignment - 1);
+    std::size_t padding = misalignment ? alignment - misalignment : 0;
+
+    if (!cur || padding + bytes > std::size_t(end - cur)) {
+        if (bytes + alignment > pool.block_size()) {
+            // Too large to share a block
+            detail::arena_block *block
+                = arena_block_pool::new_block(bytes + alignment);
+            block->next = large_blocks;
+            large_blocks = block;
+
+            char *p = payload(block);
+            misalignment = reinterpret_cast<std::size_t>(p) & (alignment - 1);
+            if (misalignment)
+                p += alignment - misalignment;
+
+            used_ += bytes;
+            return p;
+        }
+
+        detail::arena_block *block = pool.acquire();
+        block->next = blocks;
+        blocks = block;
+        if (!last_block)
+            last_block = block;
+        ++nblocks;
+
+        cur = payload(block);
+        end = cur + block->size;
+
+        misalignment = reinterpret_cast<std::size_t>(cur) & (alignment - 1);
+        padding = misalignment ? alignment - misalignment : 0;
+    }
+
+    char *ret = cur + padding;
+    cur = ret + bytes;
+    used_ += padding + bytes;
+    return ret;
+}
+
+inline void message_arena::do_deallocate(void*, std::size_t, std::size_t)
+{
+    // Memory only goes away with `release()`
+}
+
+inline bool
+message_arena::do_is_equal(const boost::container::pmr::memory_resource &o)
+    const BOOST_NOEXCEPT
+{
+    return this == &o;
+}
+
+inline char *message_arena::payload(detail::arena_block *block)
+{
+    return reinterpret_cast<char*>(block) + detail::arena_header_size;
+}
+
+} // namespace http
+} // namespace boost
@@ -0,0 +1,48 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_METHOD_ID_HPP
+#define BOOST_HTTP_METHOD_ID_HPP
+
+#include <boost/utility/string_view.hpp>
+#include <boost/cstdint.hpp>
+
+namespace boost {
+namespace http {
+
+/* Identifiers for the methods defined in RFC7231 (plus PATCH from RFC5789).
+   Any other method is `unknown`. */
+struct method_id
+{
+    enum value
+    {
+        unknown,
+        get,
+        head,
+        post,
+        put,
+        // `delete` is a keyword
+        delete_,
+        connect,
+        options,
+        trace,
+        patch
+    };
+
+    /* Case-sensitive (section 3.1.1 of RFC7230) classification of `method`.
+       It costs a single 64-bit comparison. */
+    static value classify(boost::string_view method);
+
+    // Spelling of `v` (empty for `unknown`)
+    static boost::string_view name(value v);
+};
+
+} // namespace http
+} // namespace boost
+
+#include "method_id.ipp"
+
+#endif // BOOST_HTTP_METHOD_ID_HPP
@@ -0,0 +1,76 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+
+inline method_id::value method_id::classify(boost::string_view method)
+{
+    // None of the known methods is longer than 7 bytes
+    if (method.size() > 7)
+        return unknown;
+
+    /* Byte `i` goes into bits `[8 * i, 8 * i + 8)`, so the word doesn't depend
+       on the endianness of the host. The size goes into the unused top byte, so
+       neither prefixes nor embedded NULs can alias a known method. */
+    boost::uint64_t word = boost::uint64_t(method.size()) << 56;
+    for (std::size_t i = 0 ; i != method.size() ; ++i) {
+        word |= boost::uint64_t(static_cast<unsigned char>(method[i]))
+            << (8 * i);
+    }
+
+    switch (word) {
+    case UINT64_C(0x0300000000544547):
+        return get;
+    case UINT64_C(0x0400000044414548):
+        return head;
+    case UINT64_C(0x0400000054534F50):
+        return post;
+    case UINT64_C(0x0300000000545550):
+        return put;
+    case UINT64_C(0x06004554454C4544):
+        return delete_;
+    case UINT64_C(0x075443454E4E4F43):
+        return connect;
+    case UINT64_C(0x07534E4F4954504F):
+        return options;
+    case UINT64_C(0x0500004543415254):
+        return trace;
+    case UINT64_C(0x0500004843544150):
+        return patch;
+    default:
+        return unknown;
+    }
+}
+
+inline boost::string_view method_id::name(value v)
+{
+    switch (v) {
+    case get:
+        return "GET";
+    case head:
+        return "HEAD";
+    case post:
+        return "POST";
+    case put:
+        return "PUT";
+    case delete_:
+        return "DELETE";
+    case connect:
+        return "CONNECT";
+    case options:
+        return "OPTIONS";
+    case trace:
+        return "TRACE";
+    case patch:
+        return "PATCH";
+    case unknown:
+        break;
+    }
+    return boost::string_view();
+}
+
+} // namespace http
+} // namespace boost
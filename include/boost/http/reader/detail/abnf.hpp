@@ -7,6 +7,8 @@
 #ifndef BOOST_HTTP_READER_DETAIL_ABNF_HPP
 #define BOOST_HTTP_READER_DETAIL_ABNF_HPP
 
+#include <boost/http/detail/char_class.hpp>
+
 namespace boost {
 namespace http {
 namespace reader {
@@ -25,7 +27,7 @@ inline bool isdigit(unsigned char c)
     /* DIGIT          =  %x30-39   ; 0-9
 
        from Appendix B of RFC5234. */
-    return c >= 0x30 && c <= 0x39;
+    return http::detail::in_class(c, http::detail::CHAR_DIGIT);
 }
 
 inline bool isalnum(unsigned char c)
@@ -35,14 +37,7 @@ inline bool isalnum(unsigned char c)
 
 inline bool is_tchar(unsigned char c)
 {
-    switch (c) {
-    case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
-    case '+': case '-': case '.': case '^': case '_': case '`': case '|':
-    case '~':
-        return true;
-    default:
-        return isalnum(c);
-    }
+    return http::detail::in_class(c, http::detail::CHAR_TCHAR);
 }
 
 inline bool is_sp(unsigned char c)
@@ -52,42 +47,25 @@ inline bool is_sp(unsigned char c)
 
 inline bool is_vchar(unsigned char c)
 {
-    return c >= '\x21' && c <= '\x7E';
+    return http::detail::in_class(c, http::detail::CHAR_VCHAR);
 }
 
 inline bool is_obs_text(unsigned char c)
 {
-    return c >= 0x80
-        // && c <= 0xFF <- This is always true for unsigned char
-        ;
+    return http::detail::in_class(c, http::detail::CHAR_OBS_TEXT);
 }
 
 inline bool is_ows(unsigned char c)
 {
-    switch (c) {
-    case '\x20':
-    case '\x09':
-        return true;
-    default:
-        return false;
-    }
+    return http::detail::in_class(c, http::detail::CHAR_OWS);
 }
 
 inline bool is_chunk_ext_char(unsigned char c)
 {
-    switch (c) {
-    case ';':
-    case '=':
-    case '"':
-    case '\t':
-    case ' ':
-    case '!':
-    case '\\':
-        return true;
-    default:
-        return is_tchar(c) || (c >= 0x23 && c <= 0x5B)
-            || (c >= 0x5D && c <= 0x7E) || is_obs_text(c) || is_vchar(c);
-    }
+    /* Every byte of `chunk-ext` (quoted-string included) is either a structural
+       byte already part of the field-value alphabet or a tchar, so both share
+       the same class. */
+    return http::detail::in_class(c, http::detail::CHAR_FIELD_VALUE);
 }
 
 } // namespace detail
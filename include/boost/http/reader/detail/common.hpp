@@ -7,7 +7,11 @@
 #ifndef BOOST_HTTP_READER_DETAIL_COMMON_HPP
 #define BOOST_HTTP_READER_DETAIL_COMMON_HPP
 
+#include <cstddef>
+
+#include <boost/cstdint.hpp>
 #include <boost/utility/string_view.hpp>
+#include <boost/http/method_id.hpp>
 #include <boost/http/reader/detail/abnf.hpp>
 
 namespace boost {
@@ -29,32 +33,105 @@ inline string_view decode_field_value(string_view in)
        whole field has been received (i.e. a job to this layer of
        abstraction).
 
-       We don't check in[0] because every header field has at least one
-       non-whitespace character. */
-    std::size_t ending_ows = 0;
+       `in` may be empty or made of OWS only (empty field values and the last
+       piece of a split field value). */
+    std::size_t n = in.size();
     const unsigned char *v = reinterpret_cast<const unsigned char*>(in.data());
-    for (std::size_t i = in.size() - 1 ; i > 0 ; --i) {
-        if (!is_ows(v[i]))
-            break;
-        else
-            ++ending_ows;
-    }
+    while (n != 0 && is_ows(v[n - 1]))
+        --n;
 
-    in.remove_suffix(ending_ows);
+    in.remove_suffix(in.size() - n);
 
     return in;
 }
 
-inline bool is_request_target_char(unsigned char c)
+/* Reads 8 bytes with byte `i` going into bits `[8 * i, 8 * i + 8)` (the same
+   layout used by `method_id::classify()`). GCC and Clang turn it into a single
+   unaligned load on little-endian hosts. */
+inline boost::uint64_t load_le64(const unsigned char *p)
 {
-    switch (c) {
-    case '?': case '/': case '-': case '.': case '_': case '~': case '%':
-    case '!': case '$': case '&': case '\'': case '(': case ')': case '*':
-    case '+': case ',': case ';': case '=': case ':': case '@':
-        return true;
-    default:
-        return isalnum(c);
+    return boost::uint64_t(p[0])
+        | boost::uint64_t(p[1]) << 8
+        | boost::uint64_t(p[2]) << 16
+        | boost::uint64_t(p[3]) << 24
+        | boost::uint64_t(p[4]) << 32
+        | boost::uint64_t(p[5]) << 40
+        | boost::uint64_t(p[6]) << 48
+        | boost::uint64_t(p[7]) << 56;
+}
+
+/* Speculatively matches a well-known method followed by SP in the 8 bytes of
+   `word` (see `load_le64()`). On success, `size` receives the size of the
+   method. Otherwise, `unknown` is returned and the caller must parse the
+   method byte by byte. */
+inline method_id::value match_common_method(boost::uint64_t word,
+                                            std::size_t &size)
+{
+    if ((word & UINT64_C(0xFFFFFFFF)) == UINT64_C(0x20544547)) {
+        size = 3;
+        return method_id::get;
+    }
+
+    if ((word & UINT64_C(0xFFFFFFFFFF)) == UINT64_C(0x2054534F50)) {
+        size = 4;
+        return method_id::post;
+    }
+
+    if ((word & UINT64_C(0xFFFFFFFF)) == UINT64_C(0x20545550)) {
+        size = 3;
+        return method_id::put;
+    }
+
+    if ((word & UINT64_C(0xFFFFFFFFFF)) == UINT64_C(0x2044414548)) {
+        size = 4;
+        return method_id::head;
+    }
+
+    if ((word & UINT64_C(0xFFFFFFFFFFFFFF)) == UINT64_C(0x204554454C4544)) {
+        size = 6;
+        return method_id::delete_;
+    }
+
+    if ((word & UINT64_C(0xFFFFFFFFFFFF)) == UINT64_C(0x204843544150)) {
+        size = 5;
+        return method_id::patch;
+    }
+
+    if ((word & UINT64_C(0xFFFFFFFFFFFF)) == UINT64_C(0x204543415254)) {
+        size = 5;
+        return method_id::trace;
+    }
+
+    if (word == UINT64_C(0x20534E4F4954504F)) {
+        size = 7;
+        return method_id::options;
+    }
+
+    if (word == UINT64_C(0x205443454E4E4F43)) {
+        size = 7;
+        return method_id::connect;
     }
+
+    return method_id::unknown;
+}
+
+// " HTTP/1." as loaded by `load_le64()`
+const boost::uint64_t http_version_prefix_le64 = UINT64_C(0x2E312F5054544820);
+
+inline bool is_request_target_char(unsigned char c)
+{
+    return http::detail::in_class(c, http::detail::CHAR_REQUEST_TARGET);
+}
+
+// `n` clamped to what `parser_state` can hold
+inline boost::uint32_t saturate32(std::size_t n)
+{
+    return (n > 0xFFFFFFFFu) ? 0xFFFFFFFFu : boost::uint32_t(n);
+}
+
+inline boost::uint16_t saturate16(std::size_t n)
+{
+    return (n > 0xFFFFu) ? boost::uint16_t(0xFFFFu) : boost::uint16_t(n);
 }
 
 } // namespace detail
@@ -0,0 +1,81 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_DETAIL_CONNECTION_HPP
+#define BOOST_HTTP_READER_DETAIL_CONNECTION_HPP
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/http/algorithm/header/header_value_any_of.hpp>
+#include <boost/http/token.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+namespace detail {
+
+/* Bits kept by the readers while the header block is read. The public ones
+   come from `token::connection_semantics`. */
+enum {
+    // "upgrade" is listed in Connection
+    CONNECTION_UPGRADE = 1 << 5,
+    // An Upgrade header field was found
+    UPGRADE_FIELD = 1 << 6
+};
+
+struct decode_connection_p
+{
+    static const bool PROC_ITER = false;
+
+    decode_connection_p(unsigned &flags)
+        : flags(flags)
+    {}
+
+    bool operator()(string_view v) const
+    {
+        using boost::algorithm::iequals;
+
+        // Connection options are case-insensitive (section 6.1 of RFC7230)
+        if (iequals(v, "close"))
+            flags |= token::connection_semantics::close;
+        else if (iequals(v, "keep-alive"))
+            flags |= token::connection_semantics::keep_alive;
+        else if (iequals(v, "upgrade"))
+            flags |= CONNECTION_UPGRADE;
+
+        return PROC_ITER;
+    }
+
+    unsigned &flags;
+};
+
+// Adds the options found in the Connection `field` to `flags`
+inline void decode_connection(string_view field, unsigned &flags)
+{
+    decode_connection_p p(flags);
+    header_value_any_of(field, p);
+}
+
+struct decode_expect_p
+{
+    bool operator()(string_view v) const
+    {
+        // The expectation is case-insensitive (section 5.1.1 of RFC7231)
+        return boost::algorithm::iequals(v, "100-continue");
+    }
+};
+
+// Whether the Expect `field` asks for a 100 (Continue) response
+inline bool decode_expect(string_view field)
+{
+    return header_value_any_of(field, decode_expect_p());
+}
+
+} // namespace detail
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_READER_DETAIL_CONNECTION_HPP
@@ -0,0 +1,167 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_DETAIL_SEGMENTED_BUFFER_HPP
+#define BOOST_HTTP_READER_DETAIL_SEGMENTED_BUFFER_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+namespace detail {
+
+/* The input of a reader when it's given as a buffer sequence (e.g. the two
+   halves of a ring buffer). The reader only ever sees one contiguous view at a
+   time: either one of the segments or, for tokens that straddle a segment
+   boundary, a small copy of the bytes around the boundary (the stitch). The
+   stitch may hold a few bytes past the straddling token, but the reader goes
+   back to the segments once it's consumed (see `leaves_stitch()`), so body
+   chunks are always handed out from the segments.
+
+   Positions are absolute offsets within the whole sequence. */
+class segmented_buffer
+{
+public:
+    typedef std::size_t size_type;
+
+    segmented_buffer()
+        : total(0)
+    {}
+
+    void clear()
+    {
+        segments.clear();
+        total = 0;
+    }
+
+    template<class ConstBufferSequence>
+    void assign(const ConstBufferSequence &buffers)
+    {
+        segments.clear();
+        total = 0;
+
+        for (typename ConstBufferSequence::const_iterator
+                 it = boost::asio::buffer_sequence_begin(buffers)
+                 ; it != boost::asio::buffer_sequence_end(buffers) ; ++it) {
+            boost::asio::const_buffer b(*it);
+            if (b.size() == 0)
+                continue;
+
+            segments.push_back(b);
+            total += b.size();
+        }
+    }
+
+    bool empty() const
+    {
+        return segments.empty();
+    }
+
+    // Sum of the sizes of every segment
+    size_type size() const
+    {
+        return total;
+    }
+
+    /* Returns the view where parsing continues. The reader consumed everything
+       up to `pos` and its current view ends at `view_end` (`pos <= view_end <=
+       size()` and `pos < size()`). `base` receives the position of the first byte of the
+       returned view.
+
+       If there are no pending bytes (`pos == view_end`), the view is the whole
+       segment holding `pos`. Otherwise, pending bytes are stitched together
+       with at least as many following bytes (so growing a straddling token
+       costs amortized linear time). */
+    boost::asio::const_buffer view(size_type pos, size_type view_end,
+                                   size_type &base)
+    {
+        assert(pos <= view_end && view_end <= total && pos < total);
+
+        if (pos == view_end) {
+            base = pos;
+            return segments[locate(base)];
+        }
+
+        size_type pending = view_end - pos;
+        size_type n = pending + std::min(total - view_end,
+                                         std::max<size_type>(pending, 256));
+
+        stitch.resize(n);
+        copy(pos, n, &stitch[0]);
+        base = pos;
+        return boost::asio::const_buffer(&stitch[0], n);
+    }
+
+    // Whether `view` is the stitch
+    bool stitched(boost::asio::const_buffer view) const
+    {
+        return !stitch.empty() && view.data() == &stitch[0];
+    }
+
+    /* Whether the reader, parsing `view` (whose first byte is at `base`),
+       should leave it for the segment holding `pos`: `view` is the stitch
+       and `pos` is already past the boundary the stitch was made for. */
+    bool leaves_stitch(boost::asio::const_buffer view, size_type base,
+                       size_type pos) const
+    {
+        if (!stitched(view) || pos >= total)
+            return false;
+
+        size_type start = base;
+        std::size_t i = locate(start);
+        return pos >= start + segments[i].size();
+    }
+
+private:
+    /* Returns the index of the segment holding `pos` and updates `pos` to the
+       position of the segment's first byte. */
+    std::size_t locate(size_type &pos) const
+    {
+        size_type start = 0;
+        for (std::size_t i = 0 ; ; ++i) {
+            if (pos < start + segments[i].size()) {
+                pos = start;
+                return i;
+            }
+            start += segments[i].size();
+        }
+    }
+
+    void copy(size_type pos, size_type n, unsigned char *out) const
+    {
+        size_type start = pos;
+        std::size_t i = locate(start);
+        size_type offset = pos - start;
+
+        while (n) {
+            size_type count = std::min(n, segments[i].size() - offset);
+            std::memcpy(out, static_cast<const unsigned char*>
+                        (segments[i].data()) + offset, count);
+            out += count;
+            n -= count;
+            offset = 0;
+            ++i;
+        }
+    }
+
+    std::vector<boost::asio::const_buffer> segments;
+    size_type total;
+    std::vector<unsigned char> stitch;
+};
+
+} // namespace detail
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_READER_DETAIL_SEGMENTED_BUFFER_HPP
@@ -0,0 +1,52 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_FIELD_FILTER_HPP
+#define BOOST_HTTP_READER_FIELD_FILTER_HPP
+
+#include <boost/cstdint.hpp>
+#include <boost/utility/string_view.hpp>
+#include <boost/http/field_name_id.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+/* The set of header (and trailer) fields an application wants to see. Fields
+   are identified by `field_name_id`, so every field name that isn't known to
+   `field_name_id` is either kept or dropped as a whole (through
+   `field_name_id::unknown`). */
+class field_filter
+{
+public:
+    // Empty (no field is wanted)
+    field_filter();
+
+    void insert(field_name_id::value id);
+
+    /* Same as `insert(field_name_id::classify(name))`. Unknown names keep
+       every unknown field. */
+    void insert(boost::string_view name);
+
+    void erase(field_name_id::value id);
+
+    bool contains(field_name_id::value id) const;
+
+private:
+    enum {
+        NWORDS = (field_name_id::x_frame_options + 1 + 63) / 64
+    };
+
+    boost::uint64_t bits[NWORDS];
+};
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#include "field_filter.ipp"
+
+#endif // BOOST_HTTP_READER_FIELD_FILTER_HPP
@@ -0,0 +1,38 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+namespace reader {
+
+inline field_filter::field_filter()
+{
+    for (int i = 0 ; i != NWORDS ; ++i)
+        bits[i] = 0;
+}
+
+inline void field_filter::insert(field_name_id::value id)
+{
+    bits[id / 64] |= boost::uint64_t(1) << (id % 64);
+}
+
+inline void field_filter::insert(boost::string_view name)
+{
+    insert(field_name_id::classify(name));
+}
+
+inline void field_filter::erase(field_name_id::value id)
+{
+    bits[id / 64] &= ~(boost::uint64_t(1) << (id % 64));
+}
+
+inline bool field_filter::contains(field_name_id::value id) const
+{
+    return bits[id / 64] & (boost::uint64_t(1) << (id % 64));
+}
+
+} // namespace reader
+} // namespace http
+} // namespace boost
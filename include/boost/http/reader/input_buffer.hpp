@@ -0,0 +1,177 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_INPUT_BUFFER_HPP
+#define BOOST_HTTP_READER_INPUT_BUFFER_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/http/token.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+class input_buffer_pool;
+
+/* Sizes of the storage an `input_buffer_pool` lends. Every buffer starts at
+   `initial_size` bytes and doubles (up to `max_size`) only while a token of the
+   start line or of a header/trailer block doesn't fit. */
+struct buffer_growth
+{
+    typedef std::size_t size_type;
+
+    // 512 bytes, up to 8 KiB
+    buffer_growth();
+
+    buffer_growth(size_type initial_size, size_type max_size);
+
+    size_type initial_size;
+    size_type max_size;
+};
+
+/* A buffer for the input of `reader::request` and `reader::response` whose
+   storage is lent by an `input_buffer_pool`. The unread bytes are kept at the
+   beginning of `data()`, as `set_buffer()` requires:
+
+       buffer.consume(parser.parsed_count());
+       // read into `buffer.prepare()` and `buffer.commit()` what was read
+       parser.set_buffer(buffer.data());
+
+   A connection that is idle between two messages holds no storage at all: the
+   pool takes it back with `detach()` and lends it again with `attach()` once
+   the connection is readable. */
+class input_buffer
+{
+public:
+    typedef std::size_t size_type;
+
+    // Holds no memory (`capacity() == 0`)
+    input_buffer();
+
+    ~input_buffer();
+
+    void swap(input_buffer &o);
+
+    size_type capacity() const;
+
+    // Number of unread bytes
+    size_type size() const;
+
+    // The unread bytes
+    boost::asio::const_buffer data() const;
+
+    /* The free space that follows the unread bytes. The unread bytes are moved
+       to the beginning of the storage first if they aren't there already. */
+    boost::asio::mutable_buffer prepare();
+
+    // Makes `n` bytes written into `prepare()` readable
+    void commit(size_type n);
+
+    // Discards `n` bytes from the head of `data()`
+    void consume(size_type n);
+
+    // Discards every unread byte
+    void clear();
+
+private:
+    friend class input_buffer_pool;
+
+    // Not copyable
+    input_buffer(const input_buffer&);
+    input_buffer &operator=(const input_buffer&);
+
+    unsigned char *storage;
+    size_type capacity_;
+    size_type head;
+    size_type size_;
+};
+
+/* Lends storage to `input_buffer`s, so the memory held for input grows with
+   the connections that are busy and not with the open ones. Storage given back
+   is kept for the next connection that becomes readable. It isn't thread-safe:
+   use one pool per thread (e.g. one per `io_context` run by a single
+   thread). */
+class input_buffer_pool
+{
+public:
+    typedef std::size_t size_type;
+
+    /* Lends `buffer_size` bytes to each buffer (they never grow). At most
+       `max_cached` free blocks of storage are kept. Extra ones are deleted. */
+    explicit input_buffer_pool(size_type buffer_size = 8192,
+                               size_type max_cached = 64);
+
+    /* Lends storage sized by `growth`. At most `max_cached` free blocks of
+       each size are kept. */
+    explicit input_buffer_pool(const buffer_growth &growth,
+                               size_type max_cached = 64);
+
+    ~input_buffer_pool();
+
+    // Size of the storage given by `attach()`
+    size_type buffer_size() const;
+
+    // Size no buffer grows past
+    size_type max_buffer_size() const;
+
+    // Gives storage to `buffer` unless it already has some
+    void attach(input_buffer &buffer);
+
+    /* To be called once `reader` asks for more data. If `buffer` is full of
+       unparsed bytes and `reader` waits for the rest of a token other than a
+       body chunk, the storage of `buffer` doubles (up to `max_buffer_size()`).
+       Returns whether `buffer` has free space afterwards (if it hasn't, the
+       token is too large). */
+    template<class Reader>
+    bool grow(input_buffer &buffer, const Reader &reader);
+
+    /* Moves the unread bytes of a grown `buffer` back to storage of
+       `buffer_size()` bytes if they fit. Meant for message boundaries. */
+    void shrink(input_buffer &buffer);
+
+    /* Takes the storage away from `buffer` if it holds no unread bytes.
+       Returns whether `buffer` is left without storage. */
+    bool detach(input_buffer &buffer);
+
+    // Number of free blocks kept for reuse (of every size)
+    size_type cached() const;
+
+private:
+    // Not copyable
+    input_buffer_pool(const input_buffer_pool&);
+    input_buffer_pool &operator=(const input_buffer_pool&);
+
+    /* Index into `blocks` of the storage of `capacity` bytes, or
+       `blocks.size()` if the pool doesn't lend that size. */
+    size_type size_class(size_type capacity) const;
+
+    unsigned char *acquire_block(size_type capacity);
+    void release_block(unsigned char *block, size_type capacity);
+
+    // Moves the unread bytes of `buffer` into new storage of `capacity` bytes
+    void resize(input_buffer &buffer, size_type capacity);
+
+    buffer_growth growth;
+    size_type max_cached;
+
+    // Free blocks of each size, smallest first
+    std::vector< std::vector<unsigned char*> > blocks;
+};
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#include "input_buffer.ipp"
+
+#endif // BOOST_HTTP_READER_INPUT_BUFFER_HPP
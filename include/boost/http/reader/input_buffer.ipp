@@ -0,0 +1,244 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+namespace reader {
+
+inline input_buffer::input_buffer()
+    : storage(NULL)
+    , capacity_(0)
+    , head(0)
+    , size_(0)
+{}
+
+inline input_buffer::~input_buffer()
+{
+    ::operator delete(static_cast<void*>(storage));
+}
+
+inline void input_buffer::swap(input_buffer &o)
+{
+    std::swap(storage, o.storage);
+    std::swap(capacity_, o.capacity_);
+    std::swap(head, o.head);
+    std::swap(size_, o.size_);
+}
+
+inline input_buffer::size_type input_buffer::capacity() const
+{
+    return capacity_;
+}
+
+inline input_buffer::size_type input_buffer::size() const
+{
+    return size_;
+}
+
+inline boost::asio::const_buffer input_buffer::data() const
+{
+    return boost::asio::const_buffer(storage + head, size_);
+}
+
+inline boost::asio::mutable_buffer input_buffer::prepare()
+{
+    if (head != 0) {
+        std::memmove(storage, storage + head, size_);
+        head = 0;
+    }
+
+    return boost::asio::mutable_buffer(storage + size_, capacity_ - size_);
+}
+
+inline void input_buffer::commit(size_type n)
+{
+    assert(n <= capacity_ - head - size_);
+    size_ += n;
+}
+
+inline void input_buffer::consume(size_type n)
+{
+    assert(n <= size_);
+    size_ -= n;
+    // Nothing to move later if everything was read
+    head = size_ ? head + n : 0;
+}
+
+inline void input_buffer::clear()
+{
+    head = 0;
+    size_ = 0;
+}
+
+inline buffer_growth::buffer_growth()
+    : initial_size(512)
+    , max_size(8192)
+{}
+
+inline buffer_growth::buffer_growth(size_type initial_size,
+                                    size_type max_size)
+    : initial_size(initial_size)
+    , max_size(max_size)
+{}
+
+inline input_buffer_pool::input_buffer_pool(size_type buffer_size,
+                                            size_type max_cached)
+    : growth(buffer_size, buffer_size)
+    , max_cached(max_cached)
+    , blocks(1)
+{}
+
+inline input_buffer_pool::input_buffer_pool(const buffer_growth &growth,
+                                            size_type max_cached)
+    : growth(growth)
+    , max_cached(max_cached)
+{
+    assert(growth.initial_size != 0 && growth.initial_size <= growth.max_size);
+
+    size_type nclasses = 1;
+    for (size_type n = growth.initial_size ; n < growth.max_size ; n *= 2)
+        ++nclasses;
+    blocks.resize(nclasses);
+}
+
+inline input_buffer_pool::~input_buffer_pool()
+{
+    for (size_type i = 0 ; i != blocks.size() ; ++i) {
+        for (size_type j = 0 ; j != blocks[i].size() ; ++j)
+            ::operator delete(static_cast<void*>(blocks[i][j]));
+    }
+}
+
+inline input_buffer_pool::size_type input_buffer_pool::buffer_size() const
+{
+    return growth.initial_size;
+}
+
+inline input_buffer_pool::size_type input_buffer_pool::max_buffer_size() const
+{
+    return growth.max_size;
+}
+
+inline void input_buffer_pool::attach(input_buffer &buffer)
+{
+    if (buffer.storage)
+        return;
+
+    buffer.storage = acquire_block(growth.initial_size);
+    buffer.capacity_ = growth.initial_size;
+    buffer.clear();
+}
+
+inline bool input_buffer_pool::detach(input_buffer &buffer)
+{
+    if (buffer.size_ != 0)
+        return false;
+
+    unsigned char *storage = buffer.storage;
+    size_type capacity = buffer.capacity_;
+    buffer.storage = NULL;
+    buffer.capacity_ = 0;
+    buffer.clear();
+
+    if (storage)
+        release_block(storage, capacity);
+
+    return true;
+}
+
+template<class Reader>
+bool input_buffer_pool::grow(input_buffer &buffer, const Reader &reader)
+{
+    if (!buffer.storage) {
+        attach(buffer);
+        return true;
+    }
+
+    if (buffer.size_ < buffer.capacity_)
+        return true;
+
+    // Body chunks are delivered as they arrive, so they never need room
+    if (reader.code() != token::code::error_insufficient_data
+        || reader.expected_token() == token::code::body_chunk
+        || buffer.capacity_ >= growth.max_size) {
+        return false;
+    }
+
+    resize(buffer, (buffer.capacity_ < growth.max_size / 2)
+           ? 2 * buffer.capacity_ : growth.max_size);
+    return true;
+}
+
+inline void input_buffer_pool::shrink(input_buffer &buffer)
+{
+    if (buffer.capacity_ <= growth.initial_size
+        || buffer.size_ > growth.initial_size) {
+        return;
+    }
+
+    resize(buffer, growth.initial_size);
+}
+
+inline input_buffer_pool::size_type input_buffer_pool::cached() const
+{
+    size_type ret = 0;
+    for (size_type i = 0 ; i != blocks.size() ; ++i)
+        ret += blocks[i].size();
+    return ret;
+}
+
+inline input_buffer_pool::size_type
+input_buffer_pool::size_class(size_type capacity) const
+{
+    size_type n = growth.initial_size;
+    for (size_type i = 0 ; i != blocks.size() ; ++i) {
+        if (n == capacity)
+            return i;
+
+        n = (n < growth.max_size / 2) ? 2 * n : growth.max_size;
+    }
+
+    return blocks.size();
+}
+
+inline unsigned char *input_buffer_pool::acquire_block(size_type capacity)
+{
+    size_type i = size_class(capacity);
+    assert(i != blocks.size());
+
+    if (blocks[i].empty())
+        return static_cast<unsigned char*>(::operator new(capacity));
+
+    unsigned char *ret = blocks[i].back();
+    blocks[i].pop_back();
+    return ret;
+}
+
+inline void input_buffer_pool::release_block(unsigned char *block,
+                                             size_type capacity)
+{
+    size_type i = size_class(capacity);
+
+    // Storage from another pool may have a size this one doesn't lend
+    if (i != blocks.size() && blocks[i].size() < max_cached)
+        blocks[i].push_back(block);
+    else
+        ::operator delete(static_cast<void*>(block));
+}
+
+inline void input_buffer_pool::resize(input_buffer &buffer, size_type capacity)
+{
+    unsigned char *storage = acquire_block(capacity);
+    std::memcpy(storage, buffer.storage + buffer.head, buffer.size_);
+    release_block(buffer.storage, buffer.capacity_);
+
+    buffer.storage = storage;
+    buffer.capacity_ = capacity;
+    buffer.head = 0;
+}
+
+} // namespace reader
+} // namespace http
+} // namespace boost
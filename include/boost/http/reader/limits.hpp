@@ -0,0 +1,51 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_LIMITS_HPP
+#define BOOST_HTTP_READER_LIMITS_HPP
+
+#include <cstddef>
+#include <limits>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+/* Bounds enforced by `reader::request` and `reader::response` while the
+   message is parsed (see `set_limits()`). Partially received tokens count
+   too, so a peer can't grow the buffer past a limit before being caught.
+   Every limit starts unbounded. */
+struct limits
+{
+    typedef std::size_t size_type;
+
+    limits();
+
+    // Header fields in the header block (`error_too_many_fields`)
+    size_type max_fields;
+
+    /* Bytes of the start line and the header fields, up to and including the
+       empty line (`error_header_block_too_large`). */
+    size_type max_header_bytes;
+
+    // Bytes of the request-target (`error_request_target_too_long`)
+    size_type max_target_size;
+
+    /* Bytes of the trailer fields, up to and including the final empty line
+       (`error_trailer_block_too_large`). */
+    size_type max_trailer_bytes;
+
+    // Bytes of each chunk extension (`error_chunk_ext_too_long`)
+    size_type max_chunk_ext_size;
+};
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#include "limits.ipp"
+
+#endif // BOOST_HTTP_READER_LIMITS_HPP
@@ -0,0 +1,20 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+namespace reader {
+
+inline limits::limits()
+    : max_fields(std::numeric_limits<size_type>::max())
+    , max_header_bytes(std::numeric_limits<size_type>::max())
+    , max_target_size(std::numeric_limits<size_type>::max())
+    , max_trailer_bytes(std::numeric_limits<size_type>::max())
+    , max_chunk_ext_size(std::numeric_limits<size_type>::max())
+{}
+
+} // namespace reader
+} // namespace http
+} // namespace boost
@@ -0,0 +1,134 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_MESSAGE_VIEW_HPP
+#define BOOST_HTTP_READER_MESSAGE_VIEW_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility/string_view.hpp>
+#include <boost/http/field_name_id.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+template<class Policy>
+class basic_request;
+
+template<class Policy>
+class basic_response;
+
+/* The header fields of the current message as positions within the buffer
+   given to the reader, filled while the reader parses the header block. The
+   first field of every known name has a slot of its own, so looking it up is
+   a single array access. Other fields (unknown names and repetitions) go to
+   an overflow list in the order they're received.
+
+   Values point into the reader's input. The reader only sees unparsed bytes,
+   so the application must keep the header block in memory right ahead of the
+   buffers it gives to the reader (e.g. release the bytes of a message only
+   once it is done with it). A view must not be shared among readers. Its
+   memory is reused across messages, so no allocation happens for messages
+   that don't overflow the reserved capacity. */
+class message_view
+{
+public:
+    typedef std::size_t size_type;
+    typedef boost::string_view view_type;
+
+    /* Reserves room for `overflow_capacity` fields without a slot of their
+       own. */
+    explicit message_view(size_type overflow_capacity = 16);
+
+    // Forgets every recorded field
+    void clear();
+
+    // Number of recorded fields
+    size_type size() const;
+
+    bool contains(field_name_id::value id) const;
+
+    // Value of the first `id` field (empty if there is none)
+    view_type get(field_name_id::value id) const;
+
+    // Value of the first field called `name` (case-insensitive)
+    view_type get(view_type name) const;
+
+    // Fields without a slot of their own, in the order they were received
+    size_type overflow_size() const;
+    field_name_id::value overflow_id(size_type i) const;
+    view_type overflow_name(size_type i) const;
+    view_type overflow_value(size_type i) const;
+
+private:
+    template<class Policy>
+    friend class basic_request;
+
+    template<class Policy>
+    friend class basic_response;
+
+    enum {
+        NSLOTS = field_name_id::x_frame_options + 1,
+        NWORDS = (NSLOTS + 63) / 64
+    };
+
+    // Bytes relative to the start of the message
+    struct span
+    {
+        boost::uint32_t offset;
+        boost::uint32_t size;
+    };
+
+    struct field
+    {
+        field_name_id::value id;
+        span name;
+        span value;
+    };
+
+    /* `consumed` bytes were released from the head of the buffer and `data`
+       is the new buffer (null if it isn't contiguous). */
+    void rebase(size_type consumed, const char *data);
+
+    // A new message starts at position `pos`
+    void start(size_type pos);
+
+    void on_field_name(field_name_id::value id, size_type pos, size_type size);
+    // Pieces of a split value are merged until the `last` one
+    void on_field_value(size_type pos, size_type size, bool last);
+
+    span make_span(size_type pos, size_type size) const;
+    view_type to_view(span s) const;
+
+    span slots[NSLOTS];
+    boost::uint64_t present[NWORDS];
+    std::vector<field> overflow;
+
+    // Name of the field whose value is being read
+    field pending;
+    // Whether pieces of the pending value were already received
+    bool pending_value;
+
+    size_type nfields;
+
+    /* Position of the message within the buffer. It becomes negative as the
+       reader releases the head of the buffer. */
+    std::ptrdiff_t base;
+    const char *data;
+};
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#include "message_view.ipp"
+
+#endif // BOOST_HTTP_READER_MESSAGE_VIEW_HPP
@@ -0,0 +1,153 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+namespace reader {
+
+inline message_view::message_view(size_type overflow_capacity)
+    : base(0)
+    , data(NULL)
+{
+    overflow.reserve(overflow_capacity);
+    clear();
+}
+
+inline void message_view::clear()
+{
+    for (int i = 0 ; i != NWORDS ; ++i)
+        present[i] = 0;
+
+    overflow.clear();
+    pending.id = field_name_id::unknown;
+    pending_value = false;
+    nfields = 0;
+}
+
+inline message_view::size_type message_view::size() const
+{
+    return nfields;
+}
+
+inline bool message_view::contains(field_name_id::value id) const
+{
+    return present[id / 64] & (boost::uint64_t(1) << (id % 64));
+}
+
+inline message_view::view_type
+message_view::get(field_name_id::value id) const
+{
+    if (id == field_name_id::unknown || !contains(id))
+        return view_type();
+
+    return to_view(slots[id]);
+}
+
+inline message_view::view_type message_view::get(view_type name) const
+{
+    field_name_id::value id = field_name_id::classify(name);
+    if (id != field_name_id::unknown)
+        return get(id);
+
+    for (size_type i = 0 ; i != overflow.size() ; ++i) {
+        if (overflow[i].id == field_name_id::unknown
+            && boost::algorithm::iequals(to_view(overflow[i].name), name)) {
+            return to_view(overflow[i].value);
+        }
+    }
+
+    return view_type();
+}
+
+inline message_view::size_type message_view::overflow_size() const
+{
+    return overflow.size();
+}
+
+inline field_name_id::value message_view::overflow_id(size_type i) const
+{
+    return overflow[i].id;
+}
+
+inline message_view::view_type message_view::overflow_name(size_type i) const
+{
+    return to_view(overflow[i].name);
+}
+
+inline message_view::view_type message_view::overflow_value(size_type i) const
+{
+    return to_view(overflow[i].value);
+}
+
+inline void message_view::rebase(size_type consumed, const char *data)
+{
+    base -= consumed;
+    this->data = data;
+}
+
+inline void message_view::start(size_type pos)
+{
+    clear();
+    base = pos;
+}
+
+inline void message_view::on_field_name(field_name_id::value id,
+                                        size_type pos, size_type size)
+{
+    pending.id = id;
+    pending.name = make_span(pos, size);
+}
+
+inline void message_view::on_field_value(size_type pos, size_type size,
+                                         bool last)
+{
+    if (!pending_value) {
+        pending.value = make_span(pos, size);
+        pending_value = true;
+    } else {
+        /* Pieces follow each other within the input. The joined span is only
+           valid while the application keeps the pieces in memory (it doesn't
+           compact a split value away). */
+        pending.value.size = boost::uint32_t(make_span(pos, size).offset + size
+                                             - pending.value.offset);
+    }
+
+    if (!last)
+        return;
+
+    pending_value = false;
+    field_name_id::value id = pending.id;
+    ++nfields;
+
+    if (id != field_name_id::unknown && !contains(id)) {
+        present[id / 64] |= boost::uint64_t(1) << (id % 64);
+        slots[id] = pending.value;
+        return;
+    }
+
+    overflow.push_back(pending);
+}
+
+inline message_view::span message_view::make_span(size_type pos,
+                                                  size_type size) const
+{
+    assert(std::ptrdiff_t(pos) >= base);
+    span ret;
+    ret.offset = boost::uint32_t(std::ptrdiff_t(pos) - base);
+    ret.size = boost::uint32_t(size);
+    return ret;
+}
+
+inline message_view::view_type message_view::to_view(span s) const
+{
+    /* Only contiguous input can be handed out as views. The header block may
+       lie ahead of `data`. */
+    assert(data);
+    return view_type(data + base + s.offset, s.size);
+}
+
+} // namespace reader
+} // namespace http
+} // namespace boost
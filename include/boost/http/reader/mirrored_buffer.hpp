@@ -0,0 +1,148 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_MIRRORED_BUFFER_HPP
+#define BOOST_HTTP_READER_MIRRORED_BUFFER_HPP
+
+#if defined(__linux__)
+#define BOOST_HTTP_READER_HAS_MIRRORED_BUFFER
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/throw_exception.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+namespace detail {
+
+/* `capacity` bytes of memory mapped twice back to back, so `[base, base +
+   2 * capacity)` is addressable and `base[i] == base[i + capacity]`. */
+struct mirrored_mapping
+{
+    unsigned char *base;
+    std::size_t capacity;
+};
+
+} // namespace detail
+
+class mirrored_buffer_pool;
+
+/* A ring buffer for the input of `reader::request` and `reader::response`. The
+   same physical pages are mapped twice back to back, so the unread bytes (and
+   the free space) are always contiguous. Bytes are never moved and the
+   contiguity requirement of `set_buffer()` holds for free:
+
+       buffer.consume(parser.parsed_count());
+       // read into `buffer.prepare()` and `buffer.commit()` what was read
+       parser.set_buffer(buffer.data());
+
+   Linux only (it uses `memfd_create()`). */
+class mirrored_buffer
+{
+public:
+    typedef std::size_t size_type;
+
+    // Holds no memory (`capacity() == 0`)
+    mirrored_buffer();
+
+    /* Maps at least `capacity` bytes (rounded up to the page size). Throws
+       `boost::system::system_error` on failure. */
+    explicit mirrored_buffer(size_type capacity);
+
+    ~mirrored_buffer();
+
+    void swap(mirrored_buffer &o);
+
+    size_type capacity() const;
+
+    // Number of unread bytes
+    size_type size() const;
+
+    // The unread bytes
+    boost::asio::const_buffer data() const;
+
+    // The free space that follows the unread bytes
+    boost::asio::mutable_buffer prepare();
+
+    // Makes `n` bytes written into `prepare()` readable
+    void commit(size_type n);
+
+    // Discards `n` bytes from the head of `data()`
+    void consume(size_type n);
+
+    // Discards every unread byte
+    void clear();
+
+private:
+    friend class mirrored_buffer_pool;
+
+    // Not copyable
+    mirrored_buffer(const mirrored_buffer&);
+    mirrored_buffer &operator=(const mirrored_buffer&);
+
+    static detail::mirrored_mapping map(size_type capacity);
+    static void unmap(detail::mirrored_mapping mapping);
+
+    detail::mirrored_mapping mapping;
+    size_type head;
+    size_type size_;
+};
+
+/* Keeps the memory of released buffers mapped so idle/closed connections give
+   it back cheaply and new connections don't pay for `mmap()`. It isn't
+   thread-safe: use one pool per thread (e.g. one per `io_context` run by a
+   single thread). */
+class mirrored_buffer_pool
+{
+public:
+    typedef std::size_t size_type;
+
+    // At most `max_cached` mappings are kept. Extra ones are unmapped.
+    explicit mirrored_buffer_pool(size_type max_cached = 64);
+
+    ~mirrored_buffer_pool();
+
+    /* Gives `buffer` empty storage of at least `capacity` bytes, reusing a
+       cached mapping when one is large enough. The previous storage of
+       `buffer` (if any) is released into the pool first. */
+    void acquire(mirrored_buffer &buffer, mirrored_buffer::size_type capacity);
+
+    // Takes the storage away from `buffer` (which ends up with no memory)
+    void release(mirrored_buffer &buffer);
+
+    // Number of mappings kept for reuse
+    size_type cached() const;
+
+private:
+    // Not copyable
+    mirrored_buffer_pool(const mirrored_buffer_pool&);
+    mirrored_buffer_pool &operator=(const mirrored_buffer_pool&);
+
+    std::vector<detail::mirrored_mapping> mappings;
+    size_type max_cached;
+};
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#include "mirrored_buffer.ipp"
+
+#endif // defined(__linux__)
+
+#endif // BOOST_HTTP_READER_MIRRORED_BUFFER_HPP
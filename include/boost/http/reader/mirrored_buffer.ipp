@@ -0,0 +1,198 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+namespace reader {
+
+inline mirrored_buffer::mirrored_buffer()
+    : head(0)
+    , size_(0)
+{
+    mapping.base = NULL;
+    mapping.capacity = 0;
+}
+
+inline mirrored_buffer::mirrored_buffer(size_type capacity)
+    : mapping(map(capacity))
+    , head(0)
+    , size_(0)
+{}
+
+inline mirrored_buffer::~mirrored_buffer()
+{
+    unmap(mapping);
+}
+
+inline void mirrored_buffer::swap(mirrored_buffer &o)
+{
+    std::swap(mapping, o.mapping);
+    std::swap(head, o.head);
+    std::swap(size_, o.size_);
+}
+
+inline mirrored_buffer::size_type mirrored_buffer::capacity() const
+{
+    return mapping.capacity;
+}
+
+inline mirrored_buffer::size_type mirrored_buffer::size() const
+{
+    return size_;
+}
+
+inline boost::asio::const_buffer mirrored_buffer::data() const
+{
+    return boost::asio::const_buffer(mapping.base + head, size_);
+}
+
+inline boost::asio::mutable_buffer mirrored_buffer::prepare()
+{
+    return boost::asio::mutable_buffer(mapping.base + head + size_,
+                                       mapping.capacity - size_);
+}
+
+inline void mirrored_buffer::commit(size_type n)
+{
+    assert(n <= mapping.capacity - size_);
+    size_ += n;
+}
+
+inline void mirrored_buffer::consume(size_type n)
+{
+    assert(n <= size_);
+    size_ -= n;
+    head += n;
+
+    // Both mappings are equivalent, so the head can always go back to the first
+    if (head >= mapping.capacity)
+        head -= mapping.capacity;
+}
+
+inline void mirrored_buffer::clear()
+{
+    head = 0;
+    size_ = 0;
+}
+
+inline detail::mirrored_mapping mirrored_buffer::map(size_type capacity)
+{
+    using boost::system::system_error;
+    using boost::system::system_category;
+
+    size_type page = sysconf(_SC_PAGESIZE);
+    detail::mirrored_mapping ret;
+    ret.capacity = (capacity + page - 1) / page * page;
+    if (ret.capacity == 0)
+        ret.capacity = page;
+
+    // `memfd_create()` only got a glibc wrapper in 2.27
+    int fd = syscall(SYS_memfd_create, "boost.http.mirrored_buffer",
+                     1 /* MFD_CLOEXEC */);
+    if (fd == -1) {
+        boost::throw_exception(system_error(errno, system_category(),
+                                            "memfd_create"));
+    }
+
+    if (ftruncate(fd, ret.capacity) == -1) {
+        int e = errno;
+        close(fd);
+        boost::throw_exception(system_error(e, system_category(),
+                                            "ftruncate"));
+    }
+
+    // Reserves the whole range first so nothing else lands between the halves
+    void *base = mmap(NULL, 2 * ret.capacity, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        int e = errno;
+        close(fd);
+        boost::throw_exception(system_error(e, system_category(), "mmap"));
+    }
+    ret.base = static_cast<unsigned char*>(base);
+
+    for (int i = 0 ; i != 2 ; ++i) {
+        if (mmap(ret.base + i * ret.capacity, ret.capacity,
+                 PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)
+            == MAP_FAILED) {
+            int e = errno;
+            munmap(base, 2 * ret.capacity);
+            close(fd);
+            boost::throw_exception(system_error(e, system_category(), "mmap"));
+        }
+    }
+
+    // The mappings keep the memory alive
+    close(fd);
+    return ret;
+}
+
+inline void mirrored_buffer::unmap(detail::mirrored_mapping mapping)
+{
+    if (mapping.base)
+        munmap(mapping.base, 2 * mapping.capacity);
+}
+
+inline mirrored_buffer_pool::mirrored_buffer_pool(size_type max_cached)
+    : max_cached(max_cached)
+{}
+
+inline mirrored_buffer_pool::~mirrored_buffer_pool()
+{
+    for (size_type i = 0 ; i != mappings.size() ; ++i)
+        mirrored_buffer::unmap(mappings[i]);
+}
+
+inline void mirrored_buffer_pool::acquire(mirrored_buffer &buffer,
+                                          mirrored_buffer::size_type capacity)
+{
+    release(buffer);
+
+    // Best fit, so small connections don't pin the large mappings
+    size_type best = mappings.size();
+    for (size_type i = 0 ; i != mappings.size() ; ++i) {
+        if (mappings[i].capacity < capacity)
+            continue;
+
+        if (best == mappings.size()
+            || mappings[i].capacity < mappings[best].capacity) {
+            best = i;
+        }
+    }
+
+    if (best == mappings.size()) {
+        buffer.mapping = mirrored_buffer::map(capacity);
+        return;
+    }
+
+    buffer.mapping = mappings[best];
+    mappings[best] = mappings.back();
+    mappings.pop_back();
+}
+
+inline void mirrored_buffer_pool::release(mirrored_buffer &buffer)
+{
+    detail::mirrored_mapping mapping = buffer.mapping;
+    buffer.mapping.base = NULL;
+    buffer.mapping.capacity = 0;
+    buffer.clear();
+
+    if (!mapping.base)
+        return;
+
+    if (mappings.size() < max_cached)
+        mappings.push_back(mapping);
+    else
+        mirrored_buffer::unmap(mapping);
+}
+
+inline mirrored_buffer_pool::size_type mirrored_buffer_pool::cached() const
+{
+    return mappings.size();
+}
+
+} // namespace reader
+} // namespace http
+} // namespace boost
@@ -0,0 +1,65 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_PARSER_STATE_HPP
+#define BOOST_HTTP_READER_PARSER_STATE_HPP
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+/* Everything `reader::request` and `reader::response` need to resume parsing a
+   message, packed to be kept per connection. Applications holding many mostly
+   idle connections keep one of these per connection and a single reader per
+   thread: the reader `load()`s a connection's state and input when bytes
+   arrive, parses what it can and `save()`s the state back once it asks for
+   more data. Neither the buffer nor the reader settings are part of it. */
+class parser_state
+{
+public:
+    // The state of a reader that was just constructed (or reset)
+    parser_state();
+
+private:
+    template<class Policy>
+    friend class basic_request;
+
+    template<class Policy>
+    friend class basic_response;
+
+    uint_least64_t body_size;
+
+    // Saturated copies of the reader counters
+    boost::uint32_t piece_offset;
+    boost::uint32_t block_size;
+    boost::uint16_t nfields;
+    /* Bytes of the partially received token that were already scanned, so
+       they aren't scanned again after `load()`. Tokens longer than that are
+       scanned again from this point. */
+    boost::uint16_t token_size;
+
+    // 0 means a new reader (the readers never save their `ERRORED` state)
+    boost::uint32_t state: 6;
+    // `version` of `request` or `connection_flags` of `response`
+    boost::uint32_t version: 2;
+    boost::uint32_t body_type: 4;
+    boost::uint32_t semantics: 7;
+    boost::uint32_t field_id: 8;
+    boost::uint32_t drop_field: 1;
+};
+
+BOOST_STATIC_ASSERT(sizeof(parser_state) <= 24);
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#include "parser_state.ipp"
+
+#endif // BOOST_HTTP_READER_PARSER_STATE_HPP
@@ -0,0 +1,26 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+namespace reader {
+
+inline parser_state::parser_state()
+    : body_size(0)
+    , piece_offset(0)
+    , block_size(0)
+    , nfields(0)
+    , token_size(0)
+    , state(0)
+    , version(0)
+    , body_type(0)
+    , semantics(0)
+    , field_id(0)
+    , drop_field(0)
+{}
+
+} // namespace reader
+} // namespace http
+} // namespace boost
@@ -0,0 +1,64 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_POLICY_HPP
+#define BOOST_HTTP_READER_POLICY_HPP
+
+#include <cstddef>
+
+#include <boost/http/token.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+/* The compile-time choices of `basic_request` and `basic_response`. A policy
+   is a class with the same static members as `default_policy` (deriving from
+   it and hiding a few members is the easiest way to write one). Branches of
+   disabled features compile away. */
+struct default_policy
+{
+    /* Whether a bare LF is rejected as the line terminator of the start line
+       and of the header fields (section 3.5 of RFC7230). Chunked bodies and
+       trailers always require CRLF. */
+    static const bool strict_crlf = false;
+
+    // Whether HTTP/1.0 messages are accepted
+    static const bool http_1_0 = true;
+
+    // Whether chunked bodies may end with trailer fields
+    static const bool trailers = true;
+
+    // Whether chunk extensions are accepted (as `chunk_ext` tokens)
+    static const bool chunk_extensions = true;
+
+    // Whether field values are handed out without their trailing OWS
+    static const bool trim_ows = true;
+
+    // Whether `set_limits()` is honoured
+    static const bool enforce_limits = true;
+
+    /* Instrumentation hook, called for every token the reader parses (including
+       the ones that never leave `next()`, such as folded `skip` tokens and
+       errors). */
+    static void on_token(token::code::value, std::size_t)
+    {}
+};
+
+/* Meant for the edge of a network: every line must end in CRLF, and neither
+   trailers nor chunk extensions are accepted. */
+struct strict_policy: default_policy
+{
+    static const bool strict_crlf = true;
+    static const bool trailers = false;
+    static const bool chunk_extensions = false;
+};
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_READER_POLICY_HPP
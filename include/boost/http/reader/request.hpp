@@ -9,9 +9,13 @@
 
 // private
 
+#include <cstring>
+
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/find.hpp>
 #include <boost/type_traits/common_type.hpp>
+#include <boost/type_traits/is_convertible.hpp>
+#include <boost/utility/enable_if.hpp>
 #include <boost/cstdint.hpp>
 
 #include <boost/http/syntax/chunk_size.hpp>
@@ -21,9 +25,19 @@
 #include <boost/http/syntax/field_name.hpp>
 #include <boost/http/syntax/field_value.hpp>
 #include <boost/http/detail/macros.hpp>
+#include <boost/http/detail/scan.hpp>
 #include <boost/http/reader/detail/transfer_encoding.hpp>
+#include <boost/http/reader/detail/connection.hpp>
 #include <boost/http/reader/detail/abnf.hpp>
 #include <boost/http/reader/detail/common.hpp>
+#include <boost/http/reader/detail/segmented_buffer.hpp>
+#include <boost/http/reader/field_filter.hpp>
+#include <boost/http/reader/limits.hpp>
+#include <boost/http/reader/message_view.hpp>
+#include <boost/http/reader/parser_state.hpp>
+#include <boost/http/reader/policy.hpp>
+#include <boost/http/reader/structural_index.hpp>
+#include <boost/http/reader/token_record.hpp>
 
 // public
 
@@ -33,7 +47,10 @@ namespace boost {
 namespace http {
 namespace reader {
 
-class request
+/* `Policy` holds the compile-time choices of the reader (see
+   `default_policy`). */
+template<class Policy>
+class basic_request
 {
 public:
     // types
@@ -42,10 +59,19 @@ public:
     typedef value_type *pointer;
     typedef boost::string_view view_type;
 
-    request();
+    basic_request();
 
     void reset();
 
+    /* Stores the progress on the current message into `s`. Only valid when
+       `code() == token::code::error_insufficient_data`. */
+    void save(parser_state &s) const;
+
+    /* Resumes the message saved into `s` (a default-constructed state starts
+       a new message). Settings are kept, but the buffer is forgotten: call
+       `set_buffer()` with the bytes that were left unparsed. */
+    void load(const parser_state &s);
+
     // Inspect current token
     token::code::value code() const;
     token::symbol::value symbol() const;
@@ -65,6 +91,14 @@ public:
     // Consumes current element and goes to the next one
     void next();
 
+    /* Records the current token and consumes it, repeatedly, until `n` tokens
+       are recorded into `out` or the reader reaches a token that needs
+       attention: `error_insufficient_data` or an error. `skip` tokens are
+       consumed but never recorded. Returns the number of recorded tokens.
+       Without a view, a filter or limits attached, the tokens of a contiguous
+       view are parsed in a single loop instead of through `next()`. */
+    size_type next_batch(token_record *out, size_type n);
+
     /**
      * It's expected that unread bytes from previous buffer will be present at
      * the beginning of \p inbuffer (i.e. you MUST NOT discard unread bytes from
@@ -72,9 +106,136 @@ public:
      */
     void set_buffer(boost::asio::const_buffer inbuffer);
 
+    /* Same as above, but the bytes are spread over a buffer sequence (e.g. the
+       two halves of a ring buffer). Tokens that straddle a segment boundary are
+       copied into an internal buffer. Views into those tokens are only valid
+       until the next call to `next()`. */
+    template<class ConstBufferSequence>
+    typename boost::disable_if<
+        boost::is_convertible<ConstBufferSequence, boost::asio::const_buffer>
+    >::type set_buffer(const ConstBufferSequence &inbuffers);
+
     size_type parsed_count() const;
 
+    /* Body bytes of the current chunk (or of the whole body if the message
+       isn't chunked) that come after the current token and haven't been
+       handed out yet. */
+    uint_least64_t body_remaining() const;
+
+    /* Informs that the application read `n` body bytes (up to
+       `body_remaining()`) straight from the connection into its own storage.
+       Only valid when `code() == token::code::error_insufficient_data`,
+       `expected_token() == token::code::body_chunk` and the whole buffer has
+       been parsed. The next buffer must start right after these bytes. */
+    void consume_body(uint_least64_t n);
+
+    /* When enabled, `skip` tokens are consumed inside `next()` and never
+       reach the application (their bytes still count in `parsed_count()`). It
+       takes effect at the next call to `next()` and survives `reset()`. */
+    void set_skip_folding(bool enabled);
+
+    /* Only the fields in `filter` get `field_name`/`field_value` (and
+       `trailer_name`/`trailer_value`) tokens. Other fields are consumed inside
+       `next()`, but they're still checked and interpreted (e.g.
+       Content-Length). Null disables filtering. `filter` must outlive its use
+       by this object. */
+    void set_field_filter(const field_filter *filter);
+
+    /* Fast framing: header fields that matter neither to the framing of the
+       message nor to `set_field_filter()` are skipped a whole line at a time
+       (looking for LF only) and without validation. Use it when you only
+       forward the bytes. */
+    void set_fast_framing(bool enabled);
+
+    /* Token splitting: a `request_target`, `field_value` or `trailer_value`
+       that fills the rest of the buffer is delivered as a piece instead of
+       waiting for the whole token. `final_piece()` tells the last piece apart. Values
+       the reader decodes itself (framing and connection fields) are never
+       split. With `set_message_view()`, the pieces of a value are recorded
+       as one span, so the header block must not be compacted away while a
+       value is being split (grow the buffer instead). */
+    void set_token_splitting(bool enabled);
+
+    /* False if the current token is a piece that continues in the next
+       token (only with token splitting). */
+    bool final_piece() const;
+
+    /* Enables the two-stage parsing of the header block (null disables it).
+       `index` must outlive its use by this object. */
+    void set_structural_index(structural_index *index);
+
+    /* Records the header fields of every message into `view` (null disables
+       it). `view` must outlive its use by this object. With token splitting,
+       a split value is recorded as a single span of the input, so it's only
+       valid if the pieces were never released (see `set_token_splitting()`). */
+    void set_message_view(message_view *view);
+
+    /* Enforces `policy` (null disables it) while parsing. A limit exceeded
+       (even by a partially received token) makes the reader fail with the
+       limit's error code. `policy` must outlive its use by this object. */
+    void set_limits(const limits *policy);
+
 private:
+    // Implementation of `value<T>()` (one overload per token tag)
+    view_type value_of(token::method) const;
+    method_id::value value_of(token::method_id) const;
+    view_type value_of(token::request_target) const;
+    int value_of(token::version) const;
+    view_type value_of(token::field_name) const;
+    field_name_id::value value_of(token::field_name_id) const;
+    view_type value_of(token::field_value) const;
+    unsigned value_of(token::connection_semantics) const;
+    token::chunk_ext::type value_of(token::chunk_ext) const;
+    boost::asio::const_buffer value_of(token::body_chunk) const;
+    view_type value_of(token::trailer_name) const;
+    view_type value_of(token::trailer_value) const;
+
+    // Parses the next token within the current contiguous view
+    void next_token();
+
+    /* Whether fast framing lets the rest of the current field line go
+       unparsed. */
+    bool skip_field_line() const;
+
+    /* Whether the current token belongs to a field hidden by the filter (must
+       be called once per token). */
+    bool drop_token();
+
+    /* Checks the token just parsed (or the partial progress on it) against
+       `limits_`. */
+    void enforce_limits();
+
+    // Runs the checks and hooks that follow every parsed token
+    void after_token();
+
+    // Moves on to the next view of a buffer sequence once the current is done
+    void next_view();
+
+    /* Whether nothing but `Policy::on_token()` has to run between two tokens
+       (no stitch to leave, no view, limits or filter to feed). */
+    bool plain_tokens() const;
+
+    // Feeds the token just parsed to `view`
+    void record_field();
+
+    // Fills an entry of the `next_batch()` tape with the current token
+    void record_token(token_record &t) const;
+
+    /* Delivers the `token_size_` bytes of the token being read as a piece of
+       `code`. Trailing OWS is left for the next piece, as it may turn out to
+       end the value. */
+    void emit_piece(token::code::value code, bool hold_ows);
+
+    // Whether the field value being read may be split
+    bool can_split_value() const;
+
+    // Bytes given to the last call to `set_buffer()`
+    size_type input_size() const;
+
+    /* Position of the first byte not in `cls` starting at `from` (or the
+       buffer size if none). */
+    size_type scan(http::detail::scan_class cls, size_type from);
+
     enum State {
         ERRORED,
         EXPECT_METHOD,
@@ -83,12 +244,17 @@ private:
         EXPECT_STATIC_STR_AFTER_TARGET,
         EXPECT_VERSION,
         EXPECT_CRLF_AFTER_VERSION,
+        /* The rest of the request line was already matched by the fast path
+           of `EXPECT_STATIC_STR_AFTER_TARGET`. */
+        EXPECT_CHECKED_VERSION,
+        EXPECT_CHECKED_CRLF_AFTER_VERSION,
         EXPECT_FIELD_NAME,
         EXPECT_COLON,
         EXPECT_OWS_AFTER_COLON,
         EXPECT_FIELD_VALUE,
         EXPECT_CRLF_AFTER_FIELD_VALUE,
         EXPECT_CRLF_AFTER_HEADERS,
+        EXPECT_SKIPPED_FIELD_LINE,
         EXPECT_BODY,
         EXPECT_END_OF_BODY,
         EXPECT_END_OF_MESSAGE,
@@ -105,7 +271,7 @@ private:
         EXPECT_CRLF_AFTER_TRAILERS
     };
 
-    enum {
+    enum Version {
         HTTP_1_0,
         NOT_HTTP_1_0_AND_HOST_NOT_READ,
         NOT_HTTP_1_0_AND_HOST_READ
@@ -113,7 +279,7 @@ private:
 
     // State that needs to be reset at every new request {{{
 
-    enum {
+    enum BodyType {
         // Initial state
         NO_BODY,
         // Set after decoding the field value {{{
@@ -131,6 +297,10 @@ private:
        `body_type == NO_BODY`. */
     uint_least64_t body_size;
 
+    /* `token::connection_semantics` flags plus the `detail::CONNECTION_UPGRADE`
+       and `detail::UPGRADE_FIELD` bits gathered along the header block. */
+    unsigned semantics;
+
     // }}}
 
     State state;
@@ -148,9 +318,44 @@ private:
        already parsed from current token. Otherwise, it contains the token
        size. */
     size_type token_size_;
+    /* The contiguous view being parsed. With buffer sequences, it's either one
+       of the segments or the stitch around a segment boundary. `ibase` is the
+       position of its first byte within the sequence. */
     boost::asio::const_buffer ibuffer;
+    size_type ibase;
+    detail::segmented_buffer isegments;
+
+    // Valid while `code_` is `method`
+    method_id::value method;
+
+    // Id of the last `field_name` or `trailer_name`, kept until the next one
+    field_name_id::value field_id;
+
+    bool fold_skip;
+    bool fast_framing;
+
+    bool split_tokens;
+    // Whether the current token continues in the next one
+    bool more_pieces;
+    // Bytes of the current token delivered in previous pieces
+    size_type piece_offset;
+
+    const field_filter *filter;
+    // Whether the current field is hidden by `filter`
+    bool drop_field;
+
+    structural_index *index;
+    message_view *view;
+
+    const limits *limits_;
+    /* Bytes of the current header or trailer block already consumed, and
+       fields in the header block. Only maintained while `limits_` is set. */
+    size_type block_size;
+    size_type nfields;
 };
 
+typedef basic_request<default_policy> request;
+
 } // namespace reader
 } // namespace http
 } // namespace boost
@@ -2,39 +2,68 @@ namespace boost {
 namespace http {
 namespace reader {
 
-inline
-response::response()
+template<class Policy>
+basic_response<Policy>::basic_response()
     : connection_flags(0)
     , body_type(UNKNOWN_BODY)
+    , body_size(0)
+    , semantics(0)
     , state(EXPECT_VERSION_STATIC_STR)
     , code_(token::code::error_insufficient_data)
     , idx(0)
     , token_size_(0)
+    , ibase(0)
+    , field_id(field_name_id::unknown)
+    , fold_skip(false)
+    , fast_framing(false)
+    , split_tokens(false)
+    , more_pieces(false)
+    , piece_offset(0)
+    , filter(NULL)
+    , drop_field(false)
+    , index(NULL)
+    , view(NULL)
+    , limits_(NULL)
+    , block_size(0)
+    , nfields(0)
 {}
 
-template<>
-inline uint_least16_t response::value<token::status_code>() const
+template<class Policy>
+template<class T>
+typename T::type basic_response<Policy>::value() const
+{
+    return value_of(T());
+}
+
+template<class Policy>
+uint_least16_t basic_response<Policy>::value_of(token::status_code) const
 {
     assert(code_ == token::status_code::code);
     view_type view(static_cast<const char*>(ibuffer.data()) + idx, token_size_);
     return syntax::status_code<char>::decode(view);
 }
 
-inline
-void response::set_method(view_type method)
+template<class Policy>
+void basic_response<Policy>::set_method(view_type method)
+{
+    set_method(method_id::classify(method));
+}
+
+template<class Policy>
+void basic_response<Policy>::set_method(method_id::value method)
 {
     assert(code_ == token::code::status_code);
     uint_least16_t status_code = value<token::status_code>();
     uint_least16_t code_class = status_code / 100;
 
     if (code_class == 1 || status_code == 204 || status_code == 304
-        || method == "HEAD") {
+        || method == method_id::head) {
         body_type = FORCE_NO_BODY;
         body_size = 0;
         return;
     }
 
-    if (code_class == 2 && method == "CONNECT") {
+    if (code_class == 2 && method == method_id::connect) {
         body_type = FORCE_NO_BODY_AND_STOP;
         body_size = 0;
         return;
@@ -43,60 +72,129 @@ void response::set_method(view_type method)
     body_type = CONNECTION_DELIMITED;
 }
 
-inline void response::reset()
+template<class Policy>
+void basic_response<Policy>::reset()
 {
     connection_flags = 0;
     body_type = UNKNOWN_BODY;
+    semantics = 0;
     state = EXPECT_VERSION_STATIC_STR;
     code_ = token::code::error_insufficient_data;
     idx = 0;
     token_size_ = 0;
     ibuffer = boost::asio::const_buffer();
+    ibase = 0;
+    isegments.clear();
+    drop_field = false;
+    more_pieces = false;
+    piece_offset = 0;
+    block_size = 0;
+    nfields = 0;
+
+    if (index)
+        index->clear();
+
+    if (view)
+        view->clear();
 }
 
-inline void response::puteof()
+template<class Policy>
+void basic_response<Policy>::puteof()
 {
     connection_flags |= EOF_RECEIVED;
 }
 
-inline token::code::value response::code() const
+template<class Policy>
+void basic_response<Policy>::save(parser_state &s) const
+{
+    BOOST_STATIC_ASSERT(EXPECT_CRLF_AFTER_TRAILERS < 64);
+    BOOST_STATIC_ASSERT(HTTP_1_0 < 4);
+    BOOST_STATIC_ASSERT(READING_ENCODING < 16);
+    BOOST_STATIC_ASSERT(detail::UPGRADE_FIELD < 128);
+    BOOST_STATIC_ASSERT(field_name_id::x_frame_options < 256);
+    assert(code_ == token::code::error_insufficient_data);
+
+    s.body_size = body_size;
+    s.piece_offset = detail::saturate32(piece_offset);
+    s.block_size = detail::saturate32(block_size);
+    s.nfields = detail::saturate16(nfields);
+    s.token_size = detail::saturate16(token_size_);
+    s.state = state;
+    s.version = connection_flags;
+    s.body_type = body_type;
+    s.semantics = semantics;
+    s.field_id = field_id;
+    s.drop_field = drop_field;
+}
+
+template<class Policy>
+void basic_response<Policy>::load(const parser_state &s)
+{
+    reset();
+
+    // Positions recorded so far belong to the previous buffer
+    if (view)
+        view->start(0);
+
+    if (s.state == 0)
+        return;
+
+    body_size = s.body_size;
+    piece_offset = s.piece_offset;
+    block_size = s.block_size;
+    nfields = s.nfields;
+    token_size_ = s.token_size;
+    state = State(s.state);
+    connection_flags = boost::uint8_t(s.version);
+    body_type = BodyType(s.body_type);
+    semantics = s.semantics;
+    field_id = field_name_id::value(s.field_id);
+    drop_field = s.drop_field;
+}
+
+template<class Policy>
+token::code::value basic_response<Policy>::code() const
 {
     return code_;
 }
 
-inline token::symbol::value response::symbol() const
+template<class Policy>
+token::symbol::value basic_response<Policy>::symbol() const
 {
     return token::symbol::convert(code_);
 }
 
-inline token::category::value response::category() const
+template<class Policy>
+token::category::value basic_response<Policy>::category() const
 {
     return token::category::convert(code_);
 }
 
-inline
-response::size_type response::token_size() const
+template<class Policy>
+typename basic_response<Policy>::size_type
+basic_response<Policy>::token_size() const
 {
     return token_size_;
 }
 
-template<>
-inline int response::value<token::version>() const
+template<class Policy>
+int basic_response<Policy>::value_of(token::version) const
 {
     assert(code_ == token::version::code);
     return *(static_cast<const char*>(ibuffer.data()) + idx) - '0';
 }
 
-template<>
-inline string_view response::value<token::reason_phrase>() const
+template<class Policy>
+string_view basic_response<Policy>::value_of(token::reason_phrase) const
 {
     assert(code_ == token::reason_phrase::code);
     return view_type(static_cast<const char*>(ibuffer.data()) + idx,
                      token_size_);
 }
 
-template<>
-inline response::view_type response::value<token::field_name>() const
+template<class Policy>
+typename basic_response<Policy>::view_type
+basic_response<Policy>::value_of(token::field_name) const
 {
     // It accepts “implicit conversion” from `trailer_name`
     assert(code_ == token::field_name::code
@@ -105,18 +203,36 @@ inline response::view_type response::value<token::field_name>() const
                      token_size_);
 }
 
-template<>
-inline response::view_type response::value<token::field_value>() const
+template<class Policy>
+field_name_id::value
+basic_response<Policy>::value_of(token::field_name_id) const
+{
+    // It accepts “implicit conversion” from `trailer_name`
+    assert(code_ == token::field_name::code
+           || code_ == token::trailer_name::code);
+    return field_id;
+}
+
+template<class Policy>
+typename basic_response<Policy>::view_type
+basic_response<Policy>::value_of(token::field_value) const
 {
     // It accepts “implicit conversion” from `trailer_value`
     assert(code_ == token::field_value::code
            || code_ == token::trailer_value::code);
     view_type raw(static_cast<const char*>(ibuffer.data()) + idx, token_size_);
-    return detail::decode_field_value(raw);
+    return Policy::trim_ows ? detail::decode_field_value(raw) : raw;
 }
 
-template<>
-inline token::chunk_ext::type response::value<token::chunk_ext>() const
+template<class Policy>
+unsigned basic_response<Policy>::value_of(token::connection_semantics) const
+{
+    assert(code_ == token::connection_semantics::code);
+    return semantics & (detail::CONNECTION_UPGRADE - 1);
+}
+
+template<class Policy>
+token::chunk_ext::type basic_response<Policy>::value_of(token::chunk_ext) const
 {
     assert(code_ == token::chunk_ext::code);
     token::chunk_ext::type ret;
@@ -127,30 +243,34 @@ inline token::chunk_ext::type response::value<token::chunk_ext>() const
     return ret;
 }
 
-template<>
-inline boost::asio::const_buffer response::value<token::body_chunk>() const
+template<class Policy>
+boost::asio::const_buffer
+basic_response<Policy>::value_of(token::body_chunk) const
 {
     assert(code_ == token::body_chunk::code);
     return boost::asio::buffer(ibuffer + idx, token_size_);
 }
 
-template<>
-inline response::view_type response::value<token::trailer_name>() const
+template<class Policy>
+typename basic_response<Policy>::view_type
+basic_response<Policy>::value_of(token::trailer_name) const
 {
     assert(code_ == token::trailer_name::code);
     return view_type(static_cast<const char*>(ibuffer.data()) + idx,
                      token_size_);
 }
 
-template<>
-inline response::view_type response::value<token::trailer_value>() const
+template<class Policy>
+typename basic_response<Policy>::view_type
+basic_response<Policy>::value_of(token::trailer_value) const
 {
     assert(code_ == token::trailer_value::code);
     view_type raw(static_cast<const char*>(ibuffer.data()) + idx, token_size_);
-    return detail::decode_field_value(raw);
+    return Policy::trim_ows ? detail::decode_field_value(raw) : raw;
 }
 
-inline token::code::value response::expected_token() const
+template<class Policy>
+token::code::value basic_response<Policy>::expected_token() const
 {
     switch (state) {
     case ERRORED:
@@ -161,6 +281,7 @@ inline token::code::value response::expected_token() const
     case EXPECT_CRLF_AFTER_REASON_PHRASE:
     case EXPECT_COLON:
     case EXPECT_CRLF_AFTER_HEADERS:
+    case EXPECT_SKIPPED_FIELD_LINE:
     case EXPECT_OWS_AFTER_COLON:
     case EXPECT_CRLF_AFTER_FIELD_VALUE:
     case EXPECT_CHUNK_SIZE:
@@ -202,21 +323,489 @@ inline token::code::value response::expected_token() const
     return token::code::error_insufficient_data;
 }
 
-inline void response::set_buffer(boost::asio::const_buffer ibuffer)
+template<class Policy>
+void basic_response<Policy>::set_buffer(boost::asio::const_buffer ibuffer)
 {
+    if (index)
+        index->rebase(idx, ibuffer.size());
+
+    if (view)
+        view->rebase(ibase + idx, static_cast<const char*>(ibuffer.data()));
+
     this->ibuffer = ibuffer;
+    ibase = 0;
+    idx = 0;
+    isegments.clear();
+
+    if (code_ == token::code::error_insufficient_data)
+        next();
+}
+
+template<class Policy>
+template<class ConstBufferSequence>
+typename boost::disable_if<
+    boost::is_convertible<ConstBufferSequence, boost::asio::const_buffer>
+>::type
+basic_response<Policy>::set_buffer(const ConstBufferSequence &inbuffers)
+{
+    // Values can't be handed out as a single view if the input isn't
+    if (view)
+        view->rebase(ibase + idx, NULL);
+
+    isegments.assign(inbuffers);
+
+    boost::asio::const_buffer first;
+    ibase = 0;
+    if (!isegments.empty()) {
+        first = isegments.view(0, 0, ibase);
+
+        // The partially parsed token may already extend past the first segment
+        size_type pending = (code_ == token::code::error_insufficient_data)
+            ? token_size_ : 0;
+        if (pending > first.size())
+            first = isegments.view(0, pending, ibase);
+    }
+
+    if (index)
+        index->rebase(idx, first.size());
+
+    ibuffer = first;
     idx = 0;
 
     if (code_ == token::code::error_insufficient_data)
         next();
 }
 
-inline response::size_type response::parsed_count() const
+template<class Policy>
+typename basic_response<Policy>::size_type
+basic_response<Policy>::parsed_count() const
+{
+    return ibase + idx;
+}
+
+template<class Policy>
+typename basic_response<Policy>::size_type
+basic_response<Policy>::input_size() const
+{
+    return isegments.empty() ? ibuffer.size() : isegments.size();
+}
+
+template<class Policy>
+uint_least64_t basic_response<Policy>::body_remaining() const
+{
+    switch (state) {
+    case EXPECT_BODY:
+    case EXPECT_CHUNK_DATA:
+        return body_size;
+    case EXPECT_UNSAFE_BODY:
+        // The body ends when the connection is closed
+        return std::numeric_limits<uint_least64_t>::max();
+    default:
+        return 0;
+    }
+}
+
+template<class Policy>
+void basic_response<Policy>::consume_body(uint_least64_t n)
+{
+    assert(code_ == token::code::error_insufficient_data);
+    assert(state == EXPECT_BODY || state == EXPECT_CHUNK_DATA
+           || state == EXPECT_UNSAFE_BODY);
+    assert(ibase + idx == input_size());
+
+    if (state == EXPECT_UNSAFE_BODY)
+        return;
+
+    assert(n <= body_size);
+    body_size -= n;
+
+    if (body_size == 0) {
+        state = (state == EXPECT_BODY)
+            ? EXPECT_END_OF_BODY : EXPECT_CRLF_AFTER_CHUNK_DATA;
+    }
+}
+
+template<class Policy>
+void basic_response<Policy>::set_skip_folding(bool enabled)
+{
+    fold_skip = enabled;
+}
+
+template<class Policy>
+void basic_response<Policy>::set_fast_framing(bool enabled)
+{
+    fast_framing = enabled;
+}
+
+template<class Policy>
+void basic_response<Policy>::set_token_splitting(bool enabled)
+{
+    split_tokens = enabled;
+}
+
+template<class Policy>
+bool basic_response<Policy>::final_piece() const
+{
+    return !more_pieces;
+}
+
+template<class Policy>
+void basic_response<Policy>::set_field_filter(const field_filter *filter)
+{
+    this->filter = filter;
+}
+
+template<class Policy>
+void basic_response<Policy>::set_structural_index(structural_index *index)
+{
+    this->index = index;
+
+    if (index)
+        index->clear();
+}
+
+template<class Policy>
+void basic_response<Policy>::set_message_view(message_view *view)
+{
+    this->view = view;
+
+    if (view)
+        view->clear();
+}
+
+template<class Policy>
+void basic_response<Policy>::set_limits(const limits *policy)
+{
+    limits_ = policy;
+}
+
+template<class Policy>
+typename basic_response<Policy>::size_type
+basic_response<Policy>::scan(http::detail::scan_class cls, size_type from)
+{
+    const unsigned char *data
+        = static_cast<const unsigned char*>(ibuffer.data());
+
+    if (index)
+        return index->find(cls, data, ibuffer.size(), from);
+
+    return from + http::detail::scan(cls, data + from, ibuffer.size() - from);
+}
+
+template<class Policy>
+typename basic_response<Policy>::size_type
+basic_response<Policy>::next_batch(token_record *out, size_type n)
+{
+    size_type ret = 0;
+
+    while (ret != n && code_ != token::code::error_insufficient_data
+           && state != ERRORED && !needs_method()) {
+        if (!plain_tokens()) {
+            if (code_ != token::code::skip)
+                record_token(out[ret++]);
+
+            next();
+            continue;
+        }
+
+        /* Nothing else runs between tokens, so the state machine is driven
+           directly until the view is exhausted. */
+        do {
+            if (code_ != token::code::skip)
+                record_token(out[ret++]);
+
+            next_token();
+            if (code_ == token::code::error_insufficient_data)
+                break;
+
+            Policy::on_token(code_, token_size_);
+        } while (ret != n && state != ERRORED && !needs_method());
+
+        next_view();
+    }
+
+    return ret;
+}
+
+template<class Policy>
+bool basic_response<Policy>::plain_tokens() const
+{
+    return !isegments.stitched(ibuffer) && !view && !filter && !drop_field
+        && !(Policy::enforce_limits && limits_);
+}
+
+template<class Policy>
+bool basic_response<Policy>::needs_method() const
+{
+    return code_ == token::code::status_code && body_type == UNKNOWN_BODY;
+}
+
+template<class Policy>
+void basic_response<Policy>::record_token(token_record &t) const
+{
+    t.code = code_;
+    t.final_piece = !more_pieces;
+    t.offset = ibase + idx;
+
+    // Extents of `value<T>()`, which may exclude trailing OWS
+    switch (code_) {
+    case token::code::field_name:
+    case token::code::trailer_name:
+        t.id = field_id;
+        t.size = token_size_;
+        break;
+    case token::code::field_value:
+    case token::code::trailer_value:
+        t.id = 0;
+        t.size = value<token::field_value>().size();
+        break;
+    default:
+        t.id = 0;
+        t.size = token_size_;
+    }
+}
+
+template<class Policy>
+void basic_response<Policy>::next()
+{
+    // Folded skip tokens are only accounted for in `parsed_count()`
+    do {
+        /* Once the token that straddled a segment boundary is consumed, parsing
+           goes back to the segment, so the bytes that follow (body chunks
+           included) aren't taken from the stitch. The token is consumed here
+           instead of in `next_token()`. */
+        if (state != ERRORED
+            && code_ != token::code::error_insufficient_data
+            && isegments.leaves_stitch(ibuffer, ibase,
+                                       ibase + idx + token_size_)) {
+            size_type pos = ibase + idx + token_size_;
+            if (more_pieces)
+                piece_offset += token_size_;
+
+            ibuffer = isegments.view(pos, pos, ibase);
+            idx = pos - ibase;
+            token_size_ = 0;
+
+            if (index)
+                index->clear();
+        }
+
+        next_token();
+        after_token();
+        next_view();
+    } while ((code_ == token::code::skip && fold_skip) || drop_token());
+}
+
+template<class Policy>
+void basic_response<Policy>::next_view()
 {
-    return idx;
+    /* A buffer sequence is parsed one contiguous view at a time. Once the
+       current view is exhausted, parsing continues on the next segment (or on a
+       stitch if a token straddles the boundary). */
+    while (code_ == token::code::error_insufficient_data
+           && ibase + ibuffer.size() < input_size()) {
+        size_type pos = ibase + idx;
+        ibuffer = isegments.view(pos, ibase + ibuffer.size(), ibase);
+        idx = pos - ibase;
+
+        // Positions recorded by the index refer to the previous view
+        if (index)
+            index->clear();
+
+        next_token();
+        after_token();
+    }
 }
 
-inline void response::next()
+template<class Policy>
+bool basic_response<Policy>::skip_field_line() const
+{
+    if (!fast_framing)
+        return false;
+
+    switch (field_id) {
+    case field_name_id::transfer_encoding:
+    case field_name_id::content_length:
+    case field_name_id::connection:
+    case field_name_id::upgrade:
+        return false;
+    default:
+        return !(filter && filter->contains(field_id));
+    }
+}
+
+template<class Policy>
+bool basic_response<Policy>::drop_token()
+{
+    switch (code_) {
+    case token::code::field_name:
+    case token::code::trailer_name:
+        drop_field = filter && !filter->contains(field_id);
+        return drop_field;
+    case token::code::field_value:
+    case token::code::trailer_value:
+        return drop_field;
+    default:
+        return false;
+    }
+}
+
+template<class Policy>
+void basic_response<Policy>::enforce_limits()
+{
+    if (!Policy::enforce_limits || !limits_ || state == ERRORED)
+        return;
+
+    bool partial = code_ == token::code::error_insufficient_data;
+
+    if ((partial && state == EXPECT_CHUNK_EXT)
+        || code_ == token::code::chunk_ext) {
+        if (token_size_ > limits_->max_chunk_ext_size) {
+            state = ERRORED;
+            code_ = token::code::error_chunk_ext_too_long;
+        }
+        return;
+    }
+
+    /* Which block the token belongs to. States are declared in message order,
+       so states before `EXPECT_BODY` belong to the header block and states
+       from `EXPECT_TRAILER_NAME` on belong to the trailer block. A complete
+       `skip` token already moved `state` past itself, but it stays within the
+       same block. */
+    bool header;
+    switch (code_) {
+    case token::code::error_insufficient_data:
+    case token::code::skip:
+        if (state < EXPECT_BODY)
+            header = true;
+        else if (state >= EXPECT_TRAILER_NAME)
+            header = false;
+        else
+            return;
+        break;
+    case token::code::version:
+    case token::code::status_code:
+    case token::code::reason_phrase:
+    case token::code::field_name:
+    case token::code::field_value:
+    case token::code::end_of_headers:
+        header = true;
+        break;
+    case token::code::trailer_name:
+    case token::code::trailer_value:
+    case token::code::end_of_message:
+        header = false;
+        break;
+    default:
+        return;
+    }
+
+    size_type size = block_size + token_size_;
+    if (header && size > limits_->max_header_bytes) {
+        state = ERRORED;
+        code_ = token::code::error_header_block_too_large;
+        return;
+    }
+    if (!header && size > limits_->max_trailer_bytes) {
+        state = ERRORED;
+        code_ = token::code::error_trailer_block_too_large;
+        return;
+    }
+
+    switch (code_) {
+    case token::code::error_insufficient_data:
+        break;
+    case token::code::end_of_headers:
+        block_size = 0;
+        break;
+    case token::code::end_of_message:
+        block_size = 0;
+        nfields = 0;
+        break;
+    default:
+        block_size = size;
+    }
+}
+
+template<class Policy>
+void basic_response<Policy>::after_token()
+{
+    enforce_limits();
+
+    if (code_ != token::code::error_insufficient_data)
+        Policy::on_token(code_, token_size_);
+
+    if (view)
+        record_field();
+}
+
+template<class Policy>
+void basic_response<Policy>::record_field()
+{
+    switch (code_) {
+    case token::code::version:
+        view->start(ibase + idx);
+        break;
+    case token::code::field_name:
+        view->on_field_name(field_id, ibase + idx, token_size_);
+        break;
+    case token::code::field_value:
+        // Fields hidden by `filter` aren't recorded either
+        if (!filter || filter->contains(field_id)) {
+            view->on_field_value(ibase + idx,
+                                 value<token::field_value>().size(),
+                                 !more_pieces);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+template<class Policy>
+void basic_response<Policy>::emit_piece(token::code::value code, bool hold_ows)
+{
+    size_type n = token_size_;
+    if (hold_ows) {
+        const unsigned char *data
+            = static_cast<const unsigned char*>(ibuffer.data()) + idx;
+        while (n != 0 && detail::is_ows(data[n - 1]))
+            --n;
+    }
+
+    // Nothing to deliver yet
+    if (n == 0)
+        return;
+
+    code_ = code;
+    token_size_ = n;
+    more_pieces = true;
+}
+
+template<class Policy>
+bool basic_response<Policy>::can_split_value() const
+{
+    if (!split_tokens)
+        return false;
+
+    switch (body_type) {
+    case READING_CONTENT_LENGTH:
+    case READING_ENCODING:
+        return false;
+    default:
+        break;
+    }
+
+    switch (field_id) {
+    case field_name_id::connection:
+        return false;
+    default:
+        return true;
+    }
+}
+
+template<class Policy>
+void basic_response<Policy>::next_token()
 {
     if (state == ERRORED)
         return;
@@ -235,6 +824,7 @@ inline void response::next()
                  (connection_flags & HTTP_1_0))
             ? EXPECT_END_OF_CONNECTION_ERROR : EXPECT_VERSION_STATIC_STR;
         body_type = UNKNOWN_BODY;
+        semantics = 0;
         code_ = token::code::end_of_message;
         idx += token_size_;
         token_size_ = 0;
@@ -249,12 +839,15 @@ inline void response::next()
 
     if (code_ != token::code::error_insufficient_data) {
         idx += token_size_;
+        piece_offset = more_pieces ? piece_offset + token_size_ : 0;
+        more_pieces = false;
         token_size_ = 0;
         code_ = token::code::error_insufficient_data;
     }
 
     if (idx == ibuffer.size()) {
-        if (!(connection_flags & EOF_RECEIVED) ||
+        if (!(connection_flags & EOF_RECEIVED)
+            || ibase + idx != input_size() ||
             (body_type == CONTENT_LENGTH_READ && body_size != 0)) {
             return;
         }
@@ -302,7 +895,7 @@ inline void response::next()
         {
             unsigned char c
                 = static_cast<const unsigned char*>(ibuffer.data())[idx];
-            if (c < '0' || c > '9') {
+            if (c < '0' || c > '9' || (!Policy::http_1_0 && c == '0')) {
                 state = ERRORED;
                 code_ = token::code::error_invalid_data;
             } else {
@@ -369,12 +962,14 @@ inline void response::next()
         }
     case EXPECT_REASON_PHRASE:
         {
-            typedef syntax::reason_phrase<unsigned char> reason_phrase;
-
-            std::size_t nmatched = reason_phrase::match(rest_view);
+            // reason-phrase shares the field-value alphabet
+            std::size_t nmatched
+                = scan(http::detail::SCAN_FIELD_VALUE, idx + token_size_) - idx;
 
-            if (nmatched == rest_view.size())
+            if (nmatched == rest_view.size()) {
+                token_size_ = nmatched;
                 return;
+            }
 
             state = EXPECT_CRLF_AFTER_REASON_PHRASE;
             code_ = token::code::reason_phrase;
@@ -392,6 +987,11 @@ inline void response::next()
                 token_size_ = 2;
                 return;
             case crlf::result::lf:
+                if (Policy::strict_crlf) {
+                    state = ERRORED;
+                    code_ = token::code::error_invalid_data;
+                    return;
+                }
                 state = EXPECT_FIELD_NAME;
                 code_ = token::code::skip;
                 token_size_ = 1;
@@ -406,18 +1006,18 @@ inline void response::next()
         }
     case EXPECT_FIELD_NAME:
         {
-            using boost::algorithm::iequals;
-            typedef syntax::field_name<unsigned char> field_name;
-
-            std::size_t nmatched = field_name::match(rest_view);
+            std::size_t nmatched
+                = scan(http::detail::SCAN_TCHAR, idx + token_size_) - idx;
 
             if (nmatched == 0) {
                 state = EXPECT_CRLF_AFTER_HEADERS;
-                return next();
+                return next_token();
             }
 
-            if (nmatched == rest_view.size())
+            if (nmatched == rest_view.size()) {
+                token_size_ = nmatched;
                 return;
+            }
 
             state = EXPECT_COLON;
             code_ = token::code::field_name;
@@ -431,12 +1031,27 @@ inline void response::next()
                - CONTENT_LENGTH_READ
                - CHUNKED_ENCODING_READ
                - RANDOM_ENCODING_READ */
-            string_view field = value<token::field_name>();
+            field_id = field_name_id::classify(value<token::field_name>());
+
+            // Fields skipped by fast framing count too
+            if (Policy::enforce_limits && limits_
+                && ++nfields > limits_->max_fields) {
+                state = ERRORED;
+                code_ = token::code::error_too_many_fields;
+                return;
+            }
+
+            if (skip_field_line()) {
+                state = EXPECT_SKIPPED_FIELD_LINE;
+                code_ = token::code::error_insufficient_data;
+                return next_token();
+            }
+
             if (body_type == FORCE_NO_BODY
                 || body_type == FORCE_NO_BODY_AND_STOP) {
                 // Ignore field
-            } else if (iequals(field, "Transfer-Encoding") &&
-                       !(connection_flags & HTTP_1_0)) {
+            } else if (field_id == field_name_id::transfer_encoding
+                       && !(connection_flags & HTTP_1_0)) {
                 switch (body_type) {
                 case CONTENT_LENGTH_READ:
                     /* Transfer-Encoding overrides Content-Length (section 3.3.3
@@ -452,7 +1067,7 @@ inline void response::next()
                 default:
                     BOOST_HTTP_DETAIL_UNREACHABLE("");
                 }
-            } else if (iequals(field, "Content-Length")) {
+            } else if (field_id == field_name_id::content_length) {
                 switch (body_type) {
                 case CONNECTION_DELIMITED:
                     body_type = READING_CONTENT_LENGTH;
@@ -473,6 +1088,28 @@ inline void response::next()
 
             return;
         }
+    case EXPECT_SKIPPED_FIELD_LINE:
+        {
+            const unsigned char *data
+                = static_cast<const unsigned char*>(ibuffer.data());
+            size_type from = idx + token_size_;
+            const void *lf = std::memchr(data + from, '\n',
+                                         ibuffer.size() - from);
+
+            /* Nobody will look at this line, so partial lines are released
+               right away. */
+            if (!lf) {
+                token_size_ = ibuffer.size() - idx;
+                code_ = token::code::skip;
+                return;
+            }
+
+            state = EXPECT_FIELD_NAME;
+            code_ = token::code::skip;
+            token_size_ = static_cast<const unsigned char*>(lf) + 1
+                - (data + idx);
+            return;
+        }
     case EXPECT_COLON:
         {
             unsigned char c
@@ -505,7 +1142,7 @@ inline void response::next()
 
             if (nmatched == 0) {
                 state = EXPECT_FIELD_VALUE;
-                return next();
+                return next_token();
             }
 
             code_ = token::code::skip;
@@ -514,19 +1151,27 @@ inline void response::next()
         }
     case EXPECT_FIELD_VALUE:
         {
-            typedef syntax::left_trimmed_field_value<unsigned char> field_value;
             typedef syntax::content_length<char> content_length;
 
-            std::size_t nmatched = field_value::match(rest_view);
+            std::size_t nmatched
+                = scan(http::detail::SCAN_FIELD_VALUE, idx + token_size_) - idx;
 
-            if (nmatched == rest_view.size())
+            if (nmatched == rest_view.size()) {
+                token_size_ = nmatched;
+                if (can_split_value())
+                    emit_piece(token::code::field_value, true);
                 return;
+            }
 
             state = EXPECT_CRLF_AFTER_FIELD_VALUE;
             code_ = token::code::field_value;
             token_size_ = nmatched;
 
-            string_view field = value<token::field_value>();
+            // Framing is decided on the trimmed value whatever the policy
+            string_view field = detail::decode_field_value(
+                view_type(static_cast<const char*>(ibuffer.data()) + idx,
+                          token_size_)
+            );
             switch (body_type) {
             case READING_CONTENT_LENGTH:
                 body_type = CONTENT_LENGTH_READ;
@@ -592,6 +1237,17 @@ inline void response::next()
                 break;
             }
 
+            switch (field_id) {
+            case field_name_id::connection:
+                detail::decode_connection(field, semantics);
+                break;
+            case field_name_id::upgrade:
+                semantics |= detail::UPGRADE_FIELD;
+                break;
+            default:
+                break;
+            }
+
             return;
         }
     case EXPECT_CRLF_AFTER_FIELD_VALUE:
@@ -605,6 +1261,11 @@ inline void response::next()
                 token_size_ = 2;
                 return;
             case crlf::result::lf:
+                if (Policy::strict_crlf) {
+                    state = ERRORED;
+                    code_ = token::code::error_invalid_data;
+                    return;
+                }
                 state = EXPECT_FIELD_NAME;
                 code_ = token::code::skip;
                 token_size_ = 1;
@@ -626,6 +1287,11 @@ inline void response::next()
                 token_size_ = 2;
                 break;
             case crlf::result::lf:
+                if (Policy::strict_crlf) {
+                    state = ERRORED;
+                    code_ = token::code::error_invalid_data;
+                    return;
+                }
                 token_size_ = 1;
                 break;
             case crlf::result::insufficient_data:
@@ -662,6 +1328,23 @@ inline void response::next()
                                               " cleared when the field"
                                               " value is read");
             }
+            {
+                using token::connection_semantics;
+
+                const unsigned upgrade
+                    = detail::CONNECTION_UPGRADE | detail::UPGRADE_FIELD;
+                if ((semantics & upgrade) == upgrade)
+                    semantics |= connection_semantics::upgrade;
+
+                /* The reader itself won't go past HTTP/1.0 responses or
+                   responses that end with the connection, whatever
+                   "keep-alive" says. */
+                if (!(semantics & connection_semantics::close)
+                    && !(connection_flags & HTTP_1_0)
+                    && body_type != FORCE_NO_BODY_AND_STOP) {
+                    semantics |= connection_semantics::persistent;
+                }
+            }
             code_ = token::code::end_of_headers;
             return;
         }
@@ -692,7 +1375,8 @@ inline void response::next()
         {
             typedef syntax::chunk_size<unsigned char> cs;
 
-            std::size_t nmatched = cs::match(rest_view);
+            std::size_t nmatched
+                = token_size_ + cs::match(rest_view.substr(token_size_));
 
             if (nmatched == 0) {
                 state = ERRORED;
@@ -700,8 +1384,10 @@ inline void response::next()
                 return;
             }
 
-            if (nmatched == rest_view.size())
+            if (nmatched == rest_view.size()) {
+                token_size_ = nmatched;
                 return;
+            }
 
             switch (native_value(cs::decode(rest_view.substr(0, nmatched),
                                             body_size))) {
@@ -723,29 +1409,37 @@ inline void response::next()
         }
     case EXPECT_CHUNK_EXT:
         {
-            size_type i = idx + token_size_;
-            for ( ; i != ibuffer.size() ; ++i) {
-                unsigned char c
-                    = static_cast<const unsigned char*>(ibuffer.data())[i];
-                if (detail::is_chunk_ext_char(c))
-                    continue;
-
-                if (c != '\r') {
-                    state = ERRORED;
-                    code_ = token::code::error_invalid_data;
-                    return;
-                }
-
+            // Only the CRLF is acceptable then
+            if (!Policy::chunk_extensions) {
                 state = EXPEXT_CRLF_AFTER_CHUNK_EXT;
-                token_size_ = i - idx;
+                return next_token();
+            }
 
-                if (token_size_ == 0)
-                    return next();
+            size_type i = idx + token_size_;
+            i += http::detail::scan(http::detail::SCAN_FIELD_VALUE,
+                                    static_cast<const unsigned char*>
+                                    (ibuffer.data()) + i,
+                                    ibuffer.size() - i);
+            if (i == ibuffer.size()) {
+                token_size_ = i - idx;
+                return;
+            }
 
-                code_ = token::code::chunk_ext;
+            unsigned char c
+                = static_cast<const unsigned char*>(ibuffer.data())[i];
+            if (c != '\r') {
+                state = ERRORED;
+                code_ = token::code::error_invalid_data;
                 return;
             }
+
+            state = EXPEXT_CRLF_AFTER_CHUNK_EXT;
             token_size_ = i - idx;
+
+            if (token_size_ == 0)
+                return next_token();
+
+            code_ = token::code::chunk_ext;
             return;
         }
     case EXPEXT_CRLF_AFTER_CHUNK_EXT:
@@ -807,21 +1501,29 @@ inline void response::next()
         }
     case EXPECT_TRAILER_NAME:
         {
-            typedef syntax::field_name<unsigned char> field_name;
+            // Only the final CRLF is acceptable then
+            if (!Policy::trailers) {
+                state = EXPECT_CRLF_AFTER_TRAILERS;
+                return next_token();
+            }
 
-            std::size_t nmatched = field_name::match(rest_view);
+            std::size_t nmatched
+                = scan(http::detail::SCAN_TCHAR, idx + token_size_) - idx;
 
             if (nmatched == 0) {
                 state = EXPECT_CRLF_AFTER_TRAILERS;
-                return next();
+                return next_token();
             }
 
-            if (nmatched == rest_view.size())
+            if (nmatched == rest_view.size()) {
+                token_size_ = nmatched;
                 return;
+            }
 
             state = EXPECT_TRAILER_COLON;
             code_ = token::code::trailer_name;
             token_size_ = nmatched;
+            field_id = field_name_id::classify(value<token::field_name>());
             return;
         }
     case EXPECT_TRAILER_COLON:
@@ -856,7 +1558,7 @@ inline void response::next()
 
             if (nmatched == 0) {
                 state = EXPECT_TRAILER_VALUE;
-                return next();
+                return next_token();
             }
 
             code_ = token::code::skip;
@@ -865,12 +1567,15 @@ inline void response::next()
         }
     case EXPECT_TRAILER_VALUE:
         {
-            typedef syntax::left_trimmed_field_value<unsigned char> field_value;
-
-            std::size_t nmatched = field_value::match(rest_view);
+            std::size_t nmatched
+                = scan(http::detail::SCAN_FIELD_VALUE, idx + token_size_) - idx;
 
-            if (nmatched == rest_view.size())
+            if (nmatched == rest_view.size()) {
+                token_size_ = nmatched;
+                if (split_tokens)
+                    emit_piece(token::code::trailer_value, true);
                 return;
+            }
 
             state = EXPECT_CRLF_AFTER_TRAILER_VALUE;
             code_ = token::code::trailer_value;
@@ -910,6 +1615,7 @@ inline void response::next()
                 code_ = token::code::error_invalid_data;
             } else {
                 body_type = UNKNOWN_BODY;
+                semantics = 0;
                 state = EXPECT_VERSION_STATIC_STR;
                 code_ = token::code::end_of_message;
                 token_size_ = nmatched;
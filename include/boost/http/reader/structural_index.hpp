@@ -0,0 +1,102 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_STRUCTURAL_INDEX_HPP
+#define BOOST_HTTP_READER_STRUCTURAL_INDEX_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/http/detail/scan.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+template<class Policy>
+class basic_request;
+
+template<class Policy>
+class basic_response;
+
+/* Stage one of the two-stage header parsing: a single vectorized pass over the
+   header block records, for every byte, whether it terminates a token (CR, LF,
+   ':', SP and any other byte out of the token alphabet). The readers (stage
+   two) then find the end of each token by jumping to the next recorded
+   position instead of classifying each byte again.
+
+   The index never looks beyond the blank line that ends the header block, but
+   bytes within the header block must not change once they're handed to the
+   reader. An index must not be shared among readers. Its memory is reused
+   across messages, so no allocation happens in the steady state. */
+class structural_index
+{
+public:
+    typedef std::size_t size_type;
+
+    structural_index();
+
+    // Forgets everything indexed so far
+    void clear();
+
+private:
+    template<class Policy>
+    friend class basic_request;
+
+    template<class Policy>
+    friend class basic_response;
+
+    enum {
+        TCHAR_SLOT,
+        FIELD_VALUE_SLOT,
+        SLOT_COUNT
+    };
+
+    static int slot(http::detail::scan_class cls);
+
+    /* `consumed` bytes were released from the head of the buffer and
+       `buffer_size` is the size of the new buffer. */
+    void rebase(size_type consumed, size_type buffer_size);
+
+    /* Returns the position of the first byte not in `cls` starting at `from`
+       (or `size` if none). */
+    size_type find(http::detail::scan_class cls, const unsigned char *data,
+                   size_type size, size_type from);
+
+    /* Returns the position right after the blank line that starts at the LF
+       found at `lf` (or 0 if there is no such blank line). */
+    static size_type blank_line_end(const unsigned char *data, size_type size,
+                                    size_type lf);
+
+    void restart(size_type from);
+    void extend(const unsigned char *data, size_type size);
+    void store(int slot, std::ptrdiff_t offset, boost::uint64_t mask,
+               size_type nbits);
+
+    // One bit per byte. Bit `i` refers to the byte at position `base + i`.
+    std::vector<boost::uint64_t> bits[SLOT_COUNT];
+
+    /* Positions are relative to the current buffer, so `base` might become
+       negative as the reader releases the head of the buffer. */
+    std::ptrdiff_t base;
+
+    // Bytes in `[base, end)` are indexed
+    std::ptrdiff_t end;
+
+    // Whether the blank line that ends the header block was already indexed
+    bool complete;
+};
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#include "structural_index.ipp"
+
+#endif // BOOST_HTTP_READER_STRUCTURAL_INDEX_HPP
@@ -0,0 +1,163 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+namespace reader {
+
+inline structural_index::structural_index()
+    : base(0)
+    , end(0)
+    , complete(false)
+{}
+
+inline void structural_index::clear()
+{
+    restart(0);
+}
+
+inline int structural_index::slot(http::detail::scan_class cls)
+{
+    switch (cls) {
+    case http::detail::SCAN_TCHAR:
+        return TCHAR_SLOT;
+    case http::detail::SCAN_FIELD_VALUE:
+        return FIELD_VALUE_SLOT;
+    default:
+        assert(false);
+        return TCHAR_SLOT;
+    }
+}
+
+inline void structural_index::rebase(size_type consumed, size_type buffer_size)
+{
+    base -= consumed;
+    end -= consumed;
+
+    /* If the reader went past the indexed area or the buffer has been
+       truncated, the index no longer describes the buffer. */
+    if (end < 0 || end > std::ptrdiff_t(buffer_size))
+        restart(0);
+}
+
+inline void structural_index::restart(size_type from)
+{
+    for (int i = 0 ; i != SLOT_COUNT ; ++i)
+        bits[i].clear();
+
+    base = from;
+    end = from;
+    complete = false;
+}
+
+inline void structural_index::store(int slot, std::ptrdiff_t offset,
+                                    boost::uint64_t mask, size_type nbits)
+{
+    std::vector<boost::uint64_t> &v = bits[slot];
+    size_type word = offset / 64;
+    unsigned shift = offset % 64;
+
+    v.resize((offset + nbits + 63) / 64, 0);
+    v[word] |= mask << shift;
+    if (shift != 0 && nbits > 64 - shift)
+        v[word + 1] |= mask >> (64 - shift);
+}
+
+inline structural_index::size_type
+structural_index::blank_line_end(const unsigned char *data, size_type size,
+                                 size_type lf)
+{
+    if (lf + 1 < size && data[lf + 1] == '\n')
+        return lf + 2;
+
+    if (lf + 2 < size && data[lf + 1] == '\r' && data[lf + 2] == '\n')
+        return lf + 3;
+
+    return 0;
+}
+
+inline void structural_index::extend(const unsigned char *data, size_type size)
+{
+    /* Indexing proceeds eagerly until the blank line is found and it never goes
+       beyond it (the next pipelined message will get its own pass). */
+    do {
+        size_type n = std::min<size_type>(64, size - end);
+        const unsigned char *p = data + end;
+        size_type stop = 0;
+
+        boost::uint64_t tchar = http::detail::scan_mask(
+            http::detail::SCAN_TCHAR, p, n);
+        boost::uint64_t field_value = http::detail::scan_mask(
+            http::detail::SCAN_FIELD_VALUE, p, n);
+
+        // The blank line may start within the last pass' final bytes
+        for (std::ptrdiff_t i = std::max<std::ptrdiff_t>(end - 2, base)
+                 ; i >= 0 && i < end && !stop ; ++i) {
+            if (data[i] == '\n')
+                stop = blank_line_end(data, size, i);
+        }
+
+        // LF is always found among the field-value terminators
+        for (boost::uint64_t m = field_value ; m && !stop ; m &= m - 1) {
+            size_type i = end + http::detail::ctz64(m);
+            if (data[i] == '\n')
+                stop = blank_line_end(data, size, i);
+        }
+
+        if (stop) {
+            complete = true;
+            if (stop - end < n) {
+                n = stop - end;
+                boost::uint64_t keep = (boost::uint64_t(1) << n) - 1;
+                tchar &= keep;
+                field_value &= keep;
+            }
+        }
+
+        store(TCHAR_SLOT, end - base, tchar, n);
+        store(FIELD_VALUE_SLOT, end - base, field_value, n);
+        end += n;
+    } while (!complete && end != std::ptrdiff_t(size));
+}
+
+inline structural_index::size_type
+structural_index::find(http::detail::scan_class cls, const unsigned char *data,
+                       size_type size, size_type from)
+{
+    if (std::ptrdiff_t(from) < base || std::ptrdiff_t(from) > end)
+        restart(from);
+
+    const std::vector<boost::uint64_t> &v = bits[slot(cls)];
+
+    for (;;) {
+        for (std::ptrdiff_t i = from ; i < end ; ) {
+            size_type offset = i - base;
+            boost::uint64_t word = v[offset / 64] >> (offset % 64);
+
+            if (word) {
+                std::ptrdiff_t ret = i + http::detail::ctz64(word);
+                return (ret < end) ? ret : end;
+            }
+
+            i += 64 - offset % 64;
+        }
+
+        if (end == std::ptrdiff_t(size))
+            return size;
+
+        if (complete) {
+            // A token beyond the header block (e.g. the next message)
+            restart(from);
+        } else {
+            from = end;
+        }
+
+        extend(data, size);
+    }
+}
+
+} // namespace reader
+} // namespace http
+} // namespace boost
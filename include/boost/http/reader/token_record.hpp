@@ -0,0 +1,38 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_TOKEN_RECORD_HPP
+#define BOOST_HTTP_READER_TOKEN_RECORD_HPP
+
+#include <cstddef>
+
+#include <boost/http/token.hpp>
+
+namespace boost {
+namespace http {
+namespace reader {
+
+/* One entry of the tape filled by `next_batch()`. `[offset, offset + size)`
+   are the bytes of the token's value within the input given to
+   `set_buffer()` (positions within the whole sequence for buffer
+   sequences). */
+struct token_record
+{
+    token::code::value code;
+    // False if the token is a piece that continues in the next token
+    bool final_piece;
+    /* `method_id::value` of a `method` token or `field_name_id::value` of a
+       `field_name` or `trailer_name` token (0 otherwise). */
+    int id;
+    std::size_t offset;
+    std::size_t size;
+};
+
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_READER_TOKEN_RECORD_HPP
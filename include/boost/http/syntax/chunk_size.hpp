@@ -8,9 +8,13 @@
 #define BOOST_HTTP_SYNTAX_CHUNK_SIZE_HPP
 
 #include <cassert>
+#include <limits>
 
 #include <boost/utility/string_view.hpp>
 #include <boost/core/scoped_enum.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/http/detail/char_class.hpp>
+#include <boost/http/syntax/detail/swar.hpp>
 
 namespace boost {
 namespace http {
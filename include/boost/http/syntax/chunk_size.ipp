@@ -12,49 +12,19 @@ namespace detail {
 template<class CharT>
 bool is_hexdigit(CharT c)
 {
-    switch (c) {
-    case '0': case '1': case '2': case '3': case '4': case '5': case '6':
-    case '7': case '8': case '9': case 'A': case 'B': case 'C': case 'D':
-    case 'E': case 'F': case 'a': case 'b': case 'c': case 'd': case 'e':
-    case 'f':
-        return true;
-    default:
-        return false;
-    }
+    return http::detail::in_class(c, http::detail::CHAR_HEXDIG);
 }
 
-} // namespace detail
-
-template<class CharT>
-std::size_t chunk_size<CharT>::match(view_type view)
-{
-    std::size_t res = 0;
-
-    for (std::size_t i = 0 ; i != view.size() ; ++i) {
-        if (!detail::is_hexdigit(view[i]))
-            break;
-
-        ++res;
-    }
-
-    return res;
-}
-
-template<class CharT>
-template<class Target>
-typename chunk_size<CharT>::result
-chunk_size<CharT>::decode(view_type in, Target &out)
+/* The byte-by-byte algorithm. It's kept for wide characters and for targets
+   larger than 64 bits. */
+template<class CharT, class Target, class Result>
+Result decode_hex_bytewise(basic_string_view<CharT> in, Target &out)
 {
-    if (in.size() == 0)
-        return result::invalid;
-
-    out = 0;
-
     while (in.size() && in[0] == '0')
         in.remove_prefix(1);
 
     if (in.size() == 0)
-        return result::ok;
+        return Result::ok;
 
     Target digit = 1;
 
@@ -75,16 +45,16 @@ chunk_size<CharT>::decode(view_type in, Target &out)
             }
             break;
         default:
-            return result::invalid;
+            return Result::invalid;
         }
 
         if (std::numeric_limits<Target>::max() / digit < value)
-            return result::overflow;
+            return Result::overflow;
 
         value *= digit;
 
         if (std::numeric_limits<Target>::max() - value < out)
-            return result::overflow;
+            return Result::overflow;
 
         out += value;
 
@@ -92,14 +62,108 @@ chunk_size<CharT>::decode(view_type in, Target &out)
             break;
         } else {
             if (std::numeric_limits<Target>::max() / 16 < digit)
-                return result::overflow;
+                return Result::overflow;
             else
                 digit *= 16;
 
             --i;
         }
     }
-    return result::ok;
+    return Result::ok;
+}
+
+/* Validates and converts 8 digits at a time (see `swar.hpp`). Invalid
+   characters are reported even if the digits around them would overflow. */
+template<class CharT, class Target, class Result>
+Result decode_hex_swar(basic_string_view<CharT> in, Target &out)
+{
+    const std::size_t max_digits = 16;
+    const boost::uint64_t all_zeros = UINT64_C(0x3030303030303030);
+
+    const CharT *p = in.data();
+    std::size_t n = in.size();
+
+    while (n >= 8 && swar_load(p) == all_zeros) {
+        p += 8;
+        n -= 8;
+    }
+    while (n && *p == '0') {
+        ++p;
+        --n;
+    }
+
+    if (n > max_digits) {
+        std::size_t i = 0;
+        for ( ; n - i >= 8 ; i += 8) {
+            if (!swar_is_hexdigit(swar_load(p + i)))
+                return Result::invalid;
+        }
+        for ( ; i != n ; ++i) {
+            if (!is_hexdigit(p[i]))
+                return Result::invalid;
+        }
+        return Result::overflow;
+    }
+
+    // Leading digits first, so the rest is made of whole words
+    boost::uint64_t acc = 0;
+    std::size_t i = 0;
+    for ( ; i != n % 8 ; ++i) {
+        if (!is_hexdigit(p[i]))
+            return Result::invalid;
+
+        /* "lower case bit" = 0x20 */
+        unsigned char c = p[i] | 0x20;
+        acc = acc << 4 | (c <= '9' ? c - '0' : 10 + c - 'a');
+    }
+
+    // At most 16 digits are left, so 64 bits are enough
+    for ( ; i != n ; i += 8) {
+        boost::uint64_t word = swar_load(p + i);
+        if (!swar_is_hexdigit(word))
+            return Result::invalid;
+
+        acc = acc << 32 | swar_hex_value(word);
+    }
+
+    if (acc > boost::uint64_t(std::numeric_limits<Target>::max()))
+        return Result::overflow;
+
+    out = Target(acc);
+    return Result::ok;
+}
+
+} // namespace detail
+
+template<class CharT>
+std::size_t chunk_size<CharT>::match(view_type view)
+{
+    std::size_t res = 0;
+
+    for (std::size_t i = 0 ; i != view.size() ; ++i) {
+        if (!detail::is_hexdigit(view[i]))
+            break;
+
+        ++res;
+    }
+
+    return res;
+}
+
+template<class CharT>
+template<class Target>
+typename chunk_size<CharT>::result
+chunk_size<CharT>::decode(view_type in, Target &out)
+{
+    if (in.size() == 0)
+        return result::invalid;
+
+    out = 0;
+
+    if (sizeof(CharT) == 1 && std::numeric_limits<Target>::digits <= 64)
+        return detail::decode_hex_swar<CharT, Target, result>(in, out);
+    else
+        return detail::decode_hex_bytewise<CharT, Target, result>(in, out);
 }
 
 } // namespace syntax
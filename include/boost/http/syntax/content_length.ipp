@@ -7,21 +7,18 @@ namespace boost {
 namespace http {
 namespace syntax {
 
-template<class CharT>
-template<class Target>
-typename content_length<CharT>::result
-content_length<CharT>::decode(view_type in, Target &out)
-{
-    if (in.size() == 0)
-        return result::invalid;
-
-    out = 0;
+namespace detail {
 
+/* The byte-by-byte algorithm. It's kept for wide characters and for targets
+   larger than 64 bits. */
+template<class CharT, class Target, class Result>
+Result decode_decimal_bytewise(basic_string_view<CharT> in, Target &out)
+{
     while (in.size() && in[0] == '0')
         in.remove_prefix(1);
 
     if (in.size() == 0)
-        return result::ok;
+        return Result::ok;
 
     Target digit = 1;
 
@@ -34,16 +31,16 @@ content_length<CharT>::decode(view_type in, Target &out)
             value = in[i] - '0';
             break;
         default:
-            return result::invalid;
+            return Result::invalid;
         }
 
         if (std::numeric_limits<Target>::max() / digit < value)
-            return result::overflow;
+            return Result::overflow;
 
         value *= digit;
 
         if (std::numeric_limits<Target>::max() - value < out)
-            return result::overflow;
+            return Result::overflow;
 
         out += value;
 
@@ -51,14 +48,101 @@ content_length<CharT>::decode(view_type in, Target &out)
             break;
         } else {
             if (std::numeric_limits<Target>::max() / 10 < digit)
-                return result::overflow;
+                return Result::overflow;
             else
                 digit *= 10;
 
             --i;
         }
     }
-    return result::ok;
+    return Result::ok;
+}
+
+/* Validates and converts 8 digits at a time (see `swar.hpp`). Invalid
+   characters are reported even if the digits around them would overflow. */
+template<class CharT, class Target, class Result>
+Result decode_decimal_swar(basic_string_view<CharT> in, Target &out)
+{
+    // 18446744073709551615 is the largest 64-bit value
+    const std::size_t max_digits = 20;
+    const boost::uint64_t all_zeros = UINT64_C(0x3030303030303030);
+    const boost::uint64_t scale = 100000000;
+
+    const CharT *p = in.data();
+    std::size_t n = in.size();
+
+    while (n >= 8 && swar_load(p) == all_zeros) {
+        p += 8;
+        n -= 8;
+    }
+    while (n && *p == '0') {
+        ++p;
+        --n;
+    }
+
+    if (n > max_digits) {
+        std::size_t i = 0;
+        for ( ; n - i >= 8 ; i += 8) {
+            if (!swar_is_digit(swar_load(p + i)))
+                return Result::invalid;
+        }
+        for ( ; i != n ; ++i) {
+            if (!is_digit(p[i]))
+                return Result::invalid;
+        }
+        return Result::overflow;
+    }
+
+    // Leading digits first, so the rest is made of whole words
+    boost::uint64_t acc = 0;
+    std::size_t i = 0;
+    for ( ; i != n % 8 ; ++i) {
+        unsigned value = static_cast<unsigned char>(p[i]) - '0';
+        if (value > 9)
+            return Result::invalid;
+
+        acc = acc * 10 + value;
+    }
+
+    bool overflowed = false;
+    for ( ; i != n ; i += 8) {
+        boost::uint64_t word = swar_load(p + i);
+        if (!swar_is_digit(word))
+            return Result::invalid;
+
+        boost::uint32_t value = swar_decimal_value(word);
+        if (acc > (std::numeric_limits<boost::uint64_t>::max() - value)
+            / scale) {
+            overflowed = true;
+        }
+        acc = acc * scale + value;
+    }
+
+    if (overflowed
+        || acc > boost::uint64_t(std::numeric_limits<Target>::max())) {
+        return Result::overflow;
+    }
+
+    out = Target(acc);
+    return Result::ok;
+}
+
+} // namespace detail
+
+template<class CharT>
+template<class Target>
+typename content_length<CharT>::result
+content_length<CharT>::decode(view_type in, Target &out)
+{
+    if (in.size() == 0)
+        return result::invalid;
+
+    out = 0;
+
+    if (sizeof(CharT) == 1 && std::numeric_limits<Target>::digits <= 64)
+        return detail::decode_decimal_swar<CharT, Target, result>(in, out);
+    else
+        return detail::decode_decimal_bytewise<CharT, Target, result>(in, out);
 }
 
 } // namespace syntax
@@ -7,6 +7,8 @@
 #ifndef BOOST_HTTP_SYNTAX_DETAIL_IS_DIGIT_HPP
 #define BOOST_HTTP_SYNTAX_DETAIL_IS_DIGIT_HPP
 
+#include <boost/http/detail/char_class.hpp>
+
 namespace boost {
 namespace http {
 namespace syntax {
@@ -18,7 +20,7 @@ bool is_digit(CharT c)
     /* DIGIT          =  %x30-39   ; 0-9
 
        from Appendix B of RFC5234. */
-    return c >= 0x30 && c <= 0x39;
+    return http::detail::in_class(c, http::detail::CHAR_DIGIT);
 }
 
 } // namespace detail
@@ -7,6 +7,8 @@
 #ifndef BOOST_HTTP_SYNTAX_DETAIL_IS_OWS_HPP
 #define BOOST_HTTP_SYNTAX_DETAIL_IS_OWS_HPP
 
+#include <boost/http/detail/char_class.hpp>
+
 namespace boost {
 namespace http {
 namespace syntax {
@@ -15,13 +17,7 @@ namespace detail {
 template<class CharT>
 bool is_ows(CharT c)
 {
-    switch (c) {
-    case '\x20':
-    case '\x09':
-        return true;
-    default:
-        return false;
-    }
+    return http::detail::in_class(c, http::detail::CHAR_OWS);
 }
 
 } // namespace detail
@@ -7,6 +7,8 @@
 #ifndef BOOST_HTTP_SYNTAX_DETAIL_IS_VCHAR_HPP
 #define BOOST_HTTP_SYNTAX_DETAIL_IS_VCHAR_HPP
 
+#include <boost/http/detail/char_class.hpp>
+
 namespace boost {
 namespace http {
 namespace syntax {
@@ -15,7 +17,7 @@ namespace detail {
 template<class CharT>
 bool is_vchar(CharT c)
 {
-    return c >= '\x21' && c <= '\x7E';
+    return http::detail::in_class(c, http::detail::CHAR_VCHAR);
 }
 
 } // namespace detail
@@ -0,0 +1,103 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_SYNTAX_DETAIL_SWAR_HPP
+#define BOOST_HTTP_SYNTAX_DETAIL_SWAR_HPP
+
+#include <boost/cstdint.hpp>
+
+/* Helpers to validate and convert 8 ASCII digits held in one 64-bit word
+   ("SIMD within a register"). They're only meaningful for byte-sized
+   characters. */
+
+namespace boost {
+namespace http {
+namespace syntax {
+namespace detail {
+
+/* Reads 8 characters with character `i` going into bits `[8 * i, 8 * i + 8)`.
+   GCC and Clang turn it into a single unaligned load on little-endian
+   hosts. */
+template<class CharT>
+boost::uint64_t swar_load(const CharT *p)
+{
+    typedef unsigned char uchar;
+    return boost::uint64_t(uchar(p[0]))
+        | boost::uint64_t(uchar(p[1])) << 8
+        | boost::uint64_t(uchar(p[2])) << 16
+        | boost::uint64_t(uchar(p[3])) << 24
+        | boost::uint64_t(uchar(p[4])) << 32
+        | boost::uint64_t(uchar(p[5])) << 40
+        | boost::uint64_t(uchar(p[6])) << 48
+        | boost::uint64_t(uchar(p[7])) << 56;
+}
+
+/* The high bit of every byte of `word` that lies within `[lo, hi]`. Bytes
+   must be below 0x80, so no addition carries into the next byte. */
+inline boost::uint64_t swar_in_range(boost::uint64_t word, unsigned char lo,
+                                     unsigned char hi)
+{
+    const boost::uint64_t ones = UINT64_C(0x0101010101010101);
+    const boost::uint64_t high = UINT64_C(0x8080808080808080);
+    boost::uint64_t ge_lo = word + ones * (0x80 - lo);
+    boost::uint64_t gt_hi = word + ones * (0x7F - hi);
+    return ge_lo & ~gt_hi & high;
+}
+
+// Whether the 8 bytes of `word` are all DIGIT
+inline bool swar_is_digit(boost::uint64_t word)
+{
+    const boost::uint64_t high = UINT64_C(0x8080808080808080);
+    if (word & high)
+        return false;
+
+    return swar_in_range(word, '0', '9') == high;
+}
+
+// Whether the 8 bytes of `word` are all HEXDIG (either case)
+inline bool swar_is_hexdigit(boost::uint64_t word)
+{
+    const boost::uint64_t high = UINT64_C(0x8080808080808080);
+    if (word & high)
+        return false;
+
+    /* "lower case bit" = 0x20 */
+    boost::uint64_t lower = word | UINT64_C(0x2020202020202020);
+    return (swar_in_range(word, '0', '9') | swar_in_range(lower, 'a', 'f'))
+        == high;
+}
+
+/* Value of the 8 decimal digits in `word` (the first one being the most
+   significant). `word` must pass `swar_is_digit()`. */
+inline boost::uint32_t swar_decimal_value(boost::uint64_t word)
+{
+    word -= UINT64_C(0x3030303030303030);
+    // Pairs of digits, then groups of 4, then the whole word
+    word = (word * 10 + (word >> 8)) & UINT64_C(0x00FF00FF00FF00FF);
+    word = (word * 100 + (word >> 16)) & UINT64_C(0x0000FFFF0000FFFF);
+    return boost::uint32_t(word * 10000 + (word >> 32));
+}
+
+/* Value of the 8 hexadecimal digits in `word` (the first one being the most
+   significant). `word` must pass `swar_is_hexdigit()`. */
+inline boost::uint32_t swar_hex_value(boost::uint64_t word)
+{
+    /* Letters have the bit 0x40 set and their low nibble is 9 less than their
+       value. */
+    boost::uint64_t letters = (word >> 6) & UINT64_C(0x0101010101010101);
+    word = (word & UINT64_C(0x0F0F0F0F0F0F0F0F)) + letters * 9;
+    // Pairs of nibbles, then groups of 4, then the whole word
+    word = (word << 4 | word >> 8) & UINT64_C(0x00FF00FF00FF00FF);
+    word = (word << 8 | word >> 16) & UINT64_C(0x0000FFFF0000FFFF);
+    return boost::uint32_t(word << 16 | word >> 32);
+}
+
+} // namespace detail
+} // namespace syntax
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_SYNTAX_DETAIL_SWAR_HPP
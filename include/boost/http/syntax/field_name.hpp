@@ -8,6 +8,7 @@
 #define BOOST_HTTP_SYNTAX_FIELD_NAME_HPP
 
 #include <boost/utility/string_view.hpp>
+#include <boost/http/detail/scan.hpp>
 
 namespace boost {
 namespace http {
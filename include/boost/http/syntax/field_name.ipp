@@ -12,25 +12,16 @@ namespace detail {
 template<class CharT>
 bool is_tchar(CharT c)
 {
-    switch (c) {
-    case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
-    case '+': case '-': case '.': case '^': case '_': case '`': case '|':
-    case '~':
-        return true;
-    default:
-        return isalnum(c);
-    }
+    return http::detail::in_class(c, http::detail::CHAR_TCHAR);
 }
 
-} // namespace detail
-
 template<class CharT>
-std::size_t field_name<CharT>::match(view_type view)
+std::size_t match_tchar(basic_string_view<CharT> view)
 {
     std::size_t res = 0;
 
     for (std::size_t i = 0 ; i != view.size() ; ++i) {
-        if (!detail::is_tchar(view[i]))
+        if (!is_tchar(view[i]))
             break;
 
         ++res;
@@ -39,6 +30,28 @@ std::size_t field_name<CharT>::match(view_type view)
     return res;
 }
 
+inline std::size_t match_tchar(basic_string_view<unsigned char> view)
+{
+    return http::detail::scan(http::detail::SCAN_TCHAR, view.data(),
+                              view.size());
+}
+
+inline std::size_t match_tchar(basic_string_view<char> view)
+{
+    return http::detail::scan(http::detail::SCAN_TCHAR,
+                              reinterpret_cast<const unsigned char*>
+                              (view.data()),
+                              view.size());
+}
+
+} // namespace detail
+
+template<class CharT>
+std::size_t field_name<CharT>::match(view_type view)
+{
+    return detail::match_tchar(view);
+}
+
 } // namespace syntax
 } // namespace http
 } // namespace boost
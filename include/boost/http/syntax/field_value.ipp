@@ -13,24 +13,23 @@ namespace detail {
 template<class CharT>
 bool is_nonnull_field_value_char(CharT c)
 {
-    return is_vchar(c) || is_obs_text(c);
+    return http::detail::in_class(c, http::detail::CHAR_VCHAR
+                                  | http::detail::CHAR_OBS_TEXT);
 }
 
 template<class CharT>
 bool is_field_value_char(CharT c)
 {
-    return is_nonnull_field_value_char(c) || is_ows(c);
+    return http::detail::in_class(c, http::detail::CHAR_FIELD_VALUE);
 }
 
-} // namespace detail
-
 template<class CharT>
-std::size_t left_trimmed_field_value<CharT>::match(view_type view)
+std::size_t match_field_value(basic_string_view<CharT> view)
 {
     std::size_t res = 0;
 
     for (std::size_t i = 0 ; i != view.size() ; ++i) {
-        if (!detail::is_field_value_char(view[i]))
+        if (!is_field_value_char(view[i]))
             break;
 
         ++res;
@@ -39,6 +38,22 @@ std::size_t left_trimmed_field_value<CharT>::match(view_type view)
     return res;
 }
 
+/* `char` is left to the generic version as obs-text is never matched when
+   `char` is signed. */
+inline std::size_t match_field_value(basic_string_view<unsigned char> view)
+{
+    return http::detail::scan(http::detail::SCAN_FIELD_VALUE, view.data(),
+                              view.size());
+}
+
+} // namespace detail
+
+template<class CharT>
+std::size_t left_trimmed_field_value<CharT>::match(view_type view)
+{
+    return detail::match_field_value(view);
+}
+
 } // namespace syntax
 } // namespace http
 } // namespace boost
@@ -11,6 +11,7 @@
 #include <boost/http/syntax/detail/is_ows.hpp>
 #include <boost/http/syntax/detail/is_vchar.hpp>
 #include <boost/http/syntax/detail/is_obs_text.hpp>
+#include <boost/http/detail/scan.hpp>
 
 namespace boost {
 namespace http {
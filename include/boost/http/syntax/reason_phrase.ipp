@@ -12,18 +12,16 @@ namespace detail {
 template<class CharT>
 bool is_reason_phrase_char(CharT ch)
 {
-    return is_ows(ch) || is_vchar(ch) || is_obs_text(ch);
+    return http::detail::in_class(ch, http::detail::CHAR_FIELD_VALUE);
 }
 
-} // namespace detail
-
 template<class CharT>
-std::size_t reason_phrase<CharT>::match(view_type view)
+std::size_t match_reason_phrase(basic_string_view<CharT> view)
 {
     std::size_t res = 0;
 
     for (std::size_t i = 0 ; i != view.size() ; ++i) {
-        if (!detail::is_reason_phrase_char(view[i]))
+        if (!is_reason_phrase_char(view[i]))
             break;
 
         ++res;
@@ -32,6 +30,21 @@ std::size_t reason_phrase<CharT>::match(view_type view)
     return res;
 }
 
+// reason-phrase shares the field-value alphabet
+inline std::size_t match_reason_phrase(basic_string_view<unsigned char> view)
+{
+    return http::detail::scan(http::detail::SCAN_FIELD_VALUE, view.data(),
+                              view.size());
+}
+
+} // namespace detail
+
+template<class CharT>
+std::size_t reason_phrase<CharT>::match(view_type view)
+{
+    return detail::match_reason_phrase(view);
+}
+
 } // namespace syntax
 } // namespace http
 } // namespace boost
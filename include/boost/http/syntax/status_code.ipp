@@ -30,7 +30,8 @@ template<class CharT>
 uint_least16_t status_code<CharT>::decode(view_type view)
 {
     assert(view.size() == 3);
-    return (view[0] - '0') * 100 + (view[1] - '0') * 10 + view[2] - '0';
+    // The three '0' offsets are removed at once
+    return view[0] * 100 + view[1] * 10 + view[2] - '0' * 111;
 }
 
 } // namespace syntax
@@ -10,6 +10,8 @@
 #include <boost/utility/string_view.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/http/field_name_id.hpp>
+#include <boost/http/method_id.hpp>
 
 namespace boost {
 namespace http {
@@ -29,6 +31,13 @@ struct code
         error_content_length_overflow,
         error_invalid_transfer_encoding,
         error_chunk_size_overflow,
+        // Only reported once `reader::limits` are set {{{
+        error_request_target_too_long, // 414 (URI Too Long)
+        error_too_many_fields,         // 431 (Request Header Fields Too Large)
+        error_header_block_too_large,  // 431
+        error_trailer_block_too_large, // 431
+        error_chunk_ext_too_long,      // 431
+        // }}}
         // used to skip unneeded bytes so user can keep buffer small when asking
         // for more data
         skip,
@@ -109,6 +118,14 @@ struct field_name
     static const token::code::value code = token::code::field_name;
 };
 
+/* Not a token on its own, but a different view of `field_name` (and
+   `trailer_name`) tokens. */
+struct field_name_id
+{
+    typedef http::field_name_id::value type;
+    static const token::code::value code = token::code::field_name;
+};
+
 struct field_value
 {
     typedef boost::string_view type;
@@ -148,6 +165,29 @@ struct end_of_headers
     static const token::code::value code = token::code::end_of_headers;
 };
 
+/* Not a token on its own, but a different view of `end_of_headers` tokens: what
+   the Connection, Upgrade and Expect header fields mean for the connection,
+   decoded while the header block is read. */
+struct connection_semantics
+{
+    typedef unsigned type;
+    static const token::code::value code = token::code::end_of_headers;
+
+    enum flags
+    {
+        // "close" is listed in Connection
+        close           = 1,
+        // "keep-alive" is listed in Connection
+        keep_alive      = 1 << 1,
+        // "upgrade" is listed in Connection and there is an Upgrade field
+        upgrade         = 1 << 2,
+        // Expect: 100-continue (requests only)
+        expect_continue = 1 << 3,
+        // The connection may carry another message after this one
+        persistent      = 1 << 4
+    };
+};
+
 struct end_of_body
 {
     static const token::code::value code = token::code::end_of_body;
@@ -164,6 +204,13 @@ struct method
     static const token::code::value code = token::code::method;
 };
 
+// A different view of `method` tokens
+struct method_id
+{
+    typedef http::method_id::value type;
+    static const token::code::value code = token::code::method;
+};
+
 struct request_target
 {
     typedef boost::string_view type;
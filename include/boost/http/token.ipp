@@ -19,6 +19,11 @@ inline symbol::value symbol::convert(code::value v)
     case code::error_content_length_overflow:
     case code::error_invalid_transfer_encoding:
     case code::error_chunk_size_overflow:
+    case code::error_request_target_too_long:
+    case code::error_too_many_fields:
+    case code::error_header_block_too_large:
+    case code::error_trailer_block_too_large:
+    case code::error_chunk_ext_too_long:
         return error;
     case code::skip:
         return skip;
@@ -65,6 +70,11 @@ inline category::value category::convert(code::value v)
     case code::error_content_length_overflow:
     case code::error_invalid_transfer_encoding:
     case code::error_chunk_size_overflow:
+    case code::error_request_target_too_long:
+    case code::error_too_many_fields:
+    case code::error_header_block_too_large:
+    case code::error_trailer_block_too_large:
+    case code::error_chunk_ext_too_long:
     case code::skip:
         return status;
     case code::method:
@@ -0,0 +1,131 @@
+/* Tokens per second when a pipelined stream of requests is read through
+   `next_batch()` and through the equivalent loop over `next()` written by the
+   application (same records, skip tokens left out). Without attachments,
+   `next_batch()` runs the state machine in a single loop and should be
+   faster. This is not run by `ctest`. */
+
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/token_record.hpp>
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static std::string corpus(std::size_t nrequests)
+{
+    std::string ret;
+    for (std::size_t i = 0 ; i != nrequests ; ++i) {
+        ret += "GET /index.html?page=";
+        ret += char('0' + i % 10);
+        ret += " HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:52.0)\r\n"
+            "Accept: text/html,application/xhtml+xml;q=0.9,*/*;q=0.8\r\n"
+            "Accept-Language: en-US,en;q=0.5\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "Cookie: _ga=GA1.2.1234567890.1234567890; session=abcdef\r\n"
+            "Connection: keep-alive\r\n"
+            "\r\n";
+    }
+    return ret;
+}
+
+// Folds the records into a value, so the work stays observable
+static std::size_t consume(const reader::token_record *tape, std::size_t n)
+{
+    std::size_t ret = 0;
+    for (std::size_t i = 0 ; i != n ; ++i)
+        ret += tape[i].code + tape[i].id + tape[i].offset + tape[i].size;
+    return ret;
+}
+
+static std::size_t batched(const std::string &input)
+{
+    reader::request parser;
+    parser.set_buffer(boost::asio::buffer(input.data(), input.size()));
+
+    reader::token_record tape[64];
+    std::size_t sink = 0;
+    for (;;) {
+        std::size_t n = parser.next_batch(tape, 64);
+        sink += consume(tape, n);
+        if (n != 64)
+            break;
+    }
+    return sink;
+}
+
+static std::size_t looped(const std::string &input)
+{
+    using http::token::code;
+
+    reader::request parser;
+    parser.set_buffer(boost::asio::buffer(input.data(), input.size()));
+
+    reader::token_record tape[64];
+    std::size_t sink = 0;
+    for (;;) {
+        std::size_t n = 0;
+        while (n != 64 && parser.code() != code::error_insufficient_data
+               && parser.symbol() != http::token::symbol::error) {
+            if (parser.code() != code::skip) {
+                reader::token_record &t = tape[n++];
+                t.code = parser.code();
+                t.final_piece = parser.final_piece();
+                t.offset = parser.parsed_count();
+                t.id = 0;
+                t.size = parser.token_size();
+                switch (t.code) {
+                case code::method:
+                    t.id = parser.value<http::token::method_id>();
+                    break;
+                case code::field_name:
+                    t.id = parser.value<http::token::field_name_id>();
+                    break;
+                case code::field_value:
+                    t.size = parser.value<http::token::field_value>().size();
+                    break;
+                default:
+                    break;
+                }
+            }
+            parser.next();
+        }
+        sink += consume(tape, n);
+        if (n != 64)
+            break;
+    }
+    return sink;
+}
+
+static double run(std::size_t (*read)(const std::string&),
+                  const std::string &input, std::size_t iterations,
+                  std::size_t &sink)
+{
+    std::clock_t start = std::clock();
+    for (std::size_t i = 0 ; i != iterations ; ++i)
+        sink += read(input);
+    return double(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main()
+{
+    std::string input = corpus(256);
+    std::size_t iterations = (std::size_t(1) << 28) / input.size() + 1;
+    std::size_t sink = 0;
+
+    // Alternate the runs, so both see the same machine noise
+    double times[2] = { 0, 0 };
+    for (int round = 0 ; round != 4 ; ++round) {
+        times[0] += run(looped, input, iterations / 4, sink);
+        times[1] += run(batched, input, iterations / 4, sink);
+    }
+
+    double bytes = double(iterations / 4 * 4) * input.size();
+    std::printf("next() loop:  %6.3f ns/byte\n", times[0] / bytes * 1e9);
+    std::printf("next_batch(): %6.3f ns/byte (%zu)\n", times[1] / bytes * 1e9,
+                sink % 10);
+}
@@ -0,0 +1,100 @@
+/* Throughput of the word at a time decoders against the byte by byte ones
+   they replaced. This is not run by `ctest`. */
+
+#include <boost/http/syntax/chunk_size.hpp>
+#include <boost/http/syntax/content_length.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace http = boost::http;
+namespace syntax = http::syntax;
+
+typedef syntax::content_length<char> content_length;
+typedef syntax::chunk_size<char> chunk_size;
+
+template<class F>
+static void bench(const char *name, const std::vector<std::string> &inputs,
+                  F decode)
+{
+    typedef std::chrono::steady_clock clock;
+
+    const std::size_t iterations = 20000000 / inputs.size();
+    std::uint64_t sink = 0;
+
+    clock::time_point start = clock::now();
+    for (std::size_t i = 0 ; i != iterations ; ++i) {
+        for (std::size_t j = 0 ; j != inputs.size() ; ++j) {
+            std::uint64_t out = 0;
+            decode(boost::string_view(inputs[j]), out);
+            sink += out;
+        }
+    }
+    std::chrono::duration<double> elapsed = clock::now() - start;
+
+    double n = double(iterations) * inputs.size();
+    std::printf("%-22s %7.2f ns/value (%llu)\n", name,
+                elapsed.count() / n * 1e9,
+                static_cast<unsigned long long>(sink / iterations));
+}
+
+static std::vector<std::string> make_inputs(std::size_t digits,
+                                            const char *alphabet,
+                                            std::size_t radix)
+{
+    std::vector<std::string> ret;
+    std::uint32_t state = 1;
+    for (int i = 0 ; i != 64 ; ++i) {
+        std::string in;
+        for (std::size_t j = 0 ; j != digits ; ++j) {
+            state = state * 1103515245 + 12345;
+            in += alphabet[(state >> 16) % radix];
+        }
+        if (in[0] == '0')
+            in[0] = '1';
+        ret.push_back(in);
+    }
+    return ret;
+}
+
+int main()
+{
+    typedef content_length::result cl_result;
+    typedef chunk_size::result cs_result;
+
+    const std::size_t digits[] = { 3, 7, 12, 19 };
+    for (std::size_t i = 0 ; i != 4 ; ++i) {
+        std::vector<std::string> in = make_inputs(digits[i], "0123456789",
+                                                  10);
+        std::printf("content_length, %zu digits\n", digits[i]);
+        bench("  bytewise", in, [](boost::string_view v, std::uint64_t &out) {
+                out = 0;
+                syntax::detail::decode_decimal_bytewise<char, std::uint64_t,
+                                                        cl_result>(v, out);
+            });
+        bench("  word at a time", in,
+              [](boost::string_view v, std::uint64_t &out) {
+                  content_length::decode(v, out);
+              });
+    }
+
+    const std::size_t hex_digits[] = { 1, 4, 8, 16 };
+    for (std::size_t i = 0 ; i != 4 ; ++i) {
+        std::vector<std::string> in = make_inputs(hex_digits[i],
+                                                  "0123456789abcdefABCDEF",
+                                                  22);
+        std::printf("chunk_size, %zu digits\n", hex_digits[i]);
+        bench("  bytewise", in, [](boost::string_view v, std::uint64_t &out) {
+                out = 0;
+                syntax::detail::decode_hex_bytewise<char, std::uint64_t,
+                                                    cs_result>(v, out);
+            });
+        bench("  word at a time", in,
+              [](boost::string_view v, std::uint64_t &out) {
+                  chunk_size::decode(v, out);
+              });
+    }
+}
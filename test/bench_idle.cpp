@@ -0,0 +1,163 @@
+/* Memory held by 100k keep-alive connections that went idle after one request
+   each. Every connection either owns a fixed 8 KiB buffer or borrows one from
+   an `input_buffer_pool` only while it's readable. The parser state is kept as
+   a `parser_state` and a single reader serves every connection. This is not
+   run by `ctest`. */
+
+#include <boost/http/reader/input_buffer.hpp>
+#include <boost/http/reader/request.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const std::size_t nconnections = 100000;
+static const std::size_t buffer_size = 8192;
+
+static const char request[] =
+    "GET /index.html HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "User-Agent: bench_idle\r\n"
+    "Accept: */*\r\n"
+    "\r\n";
+
+// Resident set size in bytes (0 if unknown)
+static std::size_t rss()
+{
+#if defined(__linux__)
+    std::FILE *f = std::fopen("/proc/self/statm", "r");
+    if (!f)
+        return 0;
+
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    int n = std::fscanf(f, "%lu %lu", &size, &resident);
+    std::fclose(f);
+    return (n == 2) ? resident * sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+// Parses one whole request out of `input` and returns the number of tokens
+static std::size_t serve(reader::request &parser, reader::parser_state &state,
+                         asio::const_buffer input, std::size_t &parsed)
+{
+    std::size_t ntokens = 0;
+
+    parser.load(state);
+    parser.set_buffer(input);
+    while (parser.code() != http::token::code::error_insufficient_data) {
+        ++ntokens;
+        parser.next();
+    }
+
+    parsed = parser.parsed_count();
+    parser.save(state);
+    return ntokens;
+}
+
+struct fixed_connection
+{
+    fixed_connection()
+        : buffer(new char[buffer_size])
+    {}
+
+    std::unique_ptr<char[]> buffer;
+    reader::parser_state state;
+};
+
+struct pooled_connection
+{
+    reader::input_buffer buffer;
+    reader::parser_state state;
+};
+
+static void report(const char *name, std::size_t held, std::size_t rss_before,
+                   double seconds, std::size_t ntokens)
+{
+    std::size_t rss_after = rss();
+    std::printf("%-6s %8.2f MiB of buffers held, RSS +%8.2f MiB,"
+                " %6.1f ns/request (%zu tokens)\n", name,
+                held / 1048576.0,
+                (rss_after > rss_before ? rss_after - rss_before : 0)
+                / 1048576.0,
+                seconds / nconnections * 1e9, ntokens);
+}
+
+static void bench_pooled()
+{
+    std::size_t rss_before = rss();
+    std::vector<pooled_connection> connections(nconnections);
+    reader::input_buffer_pool pool(buffer_size);
+    reader::request parser;
+    std::size_t ntokens = 0;
+
+    std::clock_t start = std::clock();
+    for (std::size_t i = 0 ; i != nconnections ; ++i) {
+        pooled_connection &c = connections[i];
+
+        pool.attach(c.buffer);
+        asio::mutable_buffer free_space = c.buffer.prepare();
+        std::memcpy(free_space.data(), request, sizeof(request) - 1);
+        c.buffer.commit(sizeof(request) - 1);
+
+        std::size_t parsed;
+        ntokens += serve(parser, c.state, c.buffer.data(), parsed);
+        c.buffer.consume(parsed);
+
+        // Idle until the next request
+        pool.detach(c.buffer);
+    }
+    double seconds = double(std::clock() - start) / CLOCKS_PER_SEC;
+
+    std::size_t held = pool.cached() * pool.buffer_size();
+    for (std::size_t i = 0 ; i != nconnections ; ++i)
+        held += connections[i].buffer.capacity();
+
+    report("pooled", held, rss_before, seconds, ntokens);
+}
+
+static void bench_fixed()
+{
+    std::size_t rss_before = rss();
+    std::vector<fixed_connection> connections(nconnections);
+    reader::request parser;
+    std::size_t ntokens = 0;
+
+    std::clock_t start = std::clock();
+    for (std::size_t i = 0 ; i != nconnections ; ++i) {
+        fixed_connection &c = connections[i];
+        std::memcpy(c.buffer.get(), request, sizeof(request) - 1);
+
+        std::size_t parsed;
+        ntokens += serve(parser, c.state,
+                         asio::buffer(c.buffer.get(), sizeof(request) - 1),
+                         parsed);
+    }
+    double seconds = double(std::clock() - start) / CLOCKS_PER_SEC;
+
+    report("fixed", nconnections * buffer_size, rss_before, seconds, ntokens);
+}
+
+int main()
+{
+    std::printf("%zu idle connections, %zu byte buffers,"
+                " %zu byte parser_state each\n", nconnections, buffer_size,
+                sizeof(reader::parser_state));
+
+    // The pooled run goes first, as freed memory may stay in the RSS
+    bench_pooled();
+    bench_fixed();
+}
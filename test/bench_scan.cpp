@@ -0,0 +1,69 @@
+/* Throughput of every scanner tier supported by the running CPU. This is not
+   run by `ctest`. */
+
+#include <boost/http/detail/scan.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace http = boost::http;
+namespace detail = http::detail;
+
+static const char *level_name(detail::scan_level level)
+{
+    switch (level) {
+    case detail::SCAN_SCALAR:
+        return "scalar";
+    case detail::SCAN_SSE2:
+        return "sse2";
+    case detail::SCAN_AVX2:
+        return "avx2";
+    case detail::SCAN_AVX512BW:
+        return "avx512bw";
+    }
+    return "";
+}
+
+static void bench(const char *name, detail::scan_class cls,
+                  const std::string &input)
+{
+    typedef std::chrono::steady_clock clock;
+
+    const unsigned char *p
+        = reinterpret_cast<const unsigned char*>(input.data());
+    const std::size_t iterations = (std::size_t(1) << 30) / input.size();
+
+    for (int l = detail::SCAN_SCALAR ; l <= detail::detect_scan_level()
+             ; ++l) {
+        detail::scan_level level = static_cast<detail::scan_level>(l);
+        std::size_t sink = 0;
+
+        clock::time_point start = clock::now();
+        for (std::size_t i = 0 ; i != iterations ; ++i)
+            sink += detail::scan(level, cls, p, input.size());
+        std::chrono::duration<double> elapsed = clock::now() - start;
+
+        double bytes = double(iterations) * input.size();
+        std::printf("%-14s %-9s %7.2f GB/s (%zu)\n", name, level_name(level),
+                    bytes / elapsed.count() / 1e9, sink / iterations);
+    }
+}
+
+int main()
+{
+    std::string cookie;
+    while (cookie.size() < 4096)
+        cookie += "_ga=GA1.2.1234567890.1234567890; session=\"a9f8e7d6\"; ";
+    std::string target;
+    while (target.size() < 2048)
+        target += "/search?q=http+parser&lang=en-US&page=2&sort=relevance";
+    std::string name;
+    while (name.size() < 1024)
+        name += "X-Forwarded-For-";
+
+    bench("field_value", detail::SCAN_FIELD_VALUE, cookie + "\r\n");
+    bench("request_target", detail::SCAN_REQUEST_TARGET, target + " ");
+    bench("field_name", detail::SCAN_TCHAR, name + ":");
+    bench("chunk_ext", detail::SCAN_FIELD_VALUE, ";" + cookie + "\r\n");
+}
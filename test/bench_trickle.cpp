@@ -0,0 +1,144 @@
+/* CPU cost per byte when the input is handed to the readers one byte per
+   `set_buffer()` call, with a dedicated reader and with a reader that goes
+   through `save()`/`load()` between calls. Linear-time resumption keeps the
+   cost per byte flat as the header block grows. This is not run by `ctest`. */
+
+#include <boost/http/reader/parser_state.hpp>
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/response.hpp>
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static std::string big_fields(std::size_t size)
+{
+    std::string ret;
+    for (int i = 0 ; ret.size() < size / 2 ; ++i) {
+        ret += "X-Field-";
+        ret += char('A' + i % 26);
+        ret += ": some value with spaces, commas; and=\"quotes\"\r\n";
+    }
+    ret += "Cookie: ";
+    while (ret.size() < size)
+        ret += "_ga=GA1.2.1234567890.1234567890; ";
+    ret += "\r\n";
+    return ret;
+}
+
+static std::string request_corpus(std::size_t size)
+{
+    std::string ret = "POST /upload HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Transfer-Encoding: chunked\r\n";
+    ret += big_fields(size);
+    ret += "\r\n"
+        "0000000000000004\r\n"
+        "Wiki\r\n"
+        "0\r\n"
+        "Trailer-Name: ";
+    ret.append(size / 4, 't');
+    ret += "\r\n\r\n";
+    return ret;
+}
+
+static std::string response_corpus(std::size_t size)
+{
+    std::string ret = "HTTP/1.1 200 ";
+    ret.append(size / 4, 'K');
+    ret += "\r\nContent-Length: 4\r\n";
+    ret += big_fields(size);
+    ret += "\r\nbody";
+    return ret;
+}
+
+static void prepare(reader::request &)
+{}
+
+static void prepare(reader::response &parser)
+{
+    if (parser.code() == http::token::code::status_code)
+        parser.set_method(http::method_id::get);
+}
+
+/* Returns the number of tokens (to keep the work observable). `shared` goes
+   through a `parser_state` between rounds, as a reader shared among
+   connections would. */
+template<class Parser>
+std::size_t feed(const std::string &input, std::size_t chunk,
+                 bool shared = false)
+{
+    Parser parser;
+    reader::parser_state state;
+    std::string buffer;
+    std::size_t ntokens = 0;
+
+    for (std::size_t fed = 0 ; fed != input.size() ; ) {
+        std::size_t n = std::min(chunk, input.size() - fed);
+        buffer.append(input, fed, n);
+        fed += n;
+
+        if (shared)
+            parser.load(state);
+        parser.set_buffer(boost::asio::buffer(buffer.data(), buffer.size()));
+        while (parser.code() != http::token::code::error_insufficient_data) {
+            if (parser.category() == http::token::category::status
+                && parser.code() != http::token::code::skip) {
+                std::fprintf(stderr, "unexpected error token\n");
+                return ntokens;
+            }
+            ++ntokens;
+            prepare(parser);
+            parser.next();
+        }
+
+        buffer.erase(0, parser.parsed_count());
+        if (shared)
+            parser.save(state);
+    }
+
+    return ntokens;
+}
+
+template<class Parser>
+void bench(const char *name, std::string (*corpus)(std::size_t))
+{
+    const std::size_t sizes[] = { 1024, 4096, 16384, 65536 };
+
+    for (std::size_t i = 0 ; i != sizeof(sizes) / sizeof(sizes[0]) ; ++i) {
+        std::string input = corpus(sizes[i]);
+        std::size_t iterations = (std::size_t(1) << 22) / input.size() + 1;
+        std::size_t sink = 0;
+
+        std::clock_t start = std::clock();
+        for (std::size_t j = 0 ; j != iterations ; ++j)
+            sink += feed<Parser>(input, 1);
+        double trickled = double(std::clock() - start) / CLOCKS_PER_SEC;
+
+        start = std::clock();
+        for (std::size_t j = 0 ; j != iterations ; ++j)
+            sink += feed<Parser>(input, 1, true);
+        double shared = double(std::clock() - start) / CLOCKS_PER_SEC;
+
+        start = std::clock();
+        for (std::size_t j = 0 ; j != iterations ; ++j)
+            sink += feed<Parser>(input, input.size());
+        double whole = double(std::clock() - start) / CLOCKS_PER_SEC;
+
+        double bytes = double(iterations) * input.size();
+        std::printf("%-8s %6zu bytes: %7.2f ns/byte trickled, %7.2f ns/byte"
+                    " trickled through save/load, %6.2f ns/byte whole (%zu)\n",
+                    name, input.size(), trickled / bytes * 1e9,
+                    shared / bytes * 1e9, whole / bytes * 1e9,
+                    sink / iterations);
+    }
+}
+
+int main()
+{
+    bench<reader::request>("request", request_corpus);
+    bench<reader::response>("response", response_corpus);
+}
@@ -0,0 +1,274 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/response.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const char request_input[] =
+    "GET / HTTP/1.1\r\n"
+    "host: aliceinthewonderland.com\t \r\n"
+    "\r\n"
+
+    "POST /upload?some=query HTTP/1.1\r\n"
+    "Content-length: 4\r\n"
+    "host:thelastringbearer.org\r\n"
+    "\r\n"
+    "ping"
+
+    "POST http://notheaven.onion/ HTTP/1.1\r\n"
+    "Host: playwithme.onion\r\n"
+    "X-Pants: On\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "4;ext=\"quoted\"\r\n"
+    "Wiki\r\n"
+    "e\r\n"
+    " in\r\n\r\nchunks.\r\n"
+    "0\r\n"
+    "Content-MD5: 25b83662323c397c9944a8a7b3fef7ab\r\n"
+    "\r\n";
+
+static const char response_input[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 5\r\n"
+    "X-Pants: On\r\n"
+    "\r\n"
+    "hello"
+
+    "HTTP/1.1 200 A longer reason phrase\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "3\r\n"
+    "abc\r\n"
+    "0\r\n"
+    "Trailer-Name: trailer value\r\n"
+    "\r\n";
+
+static void prepare(reader::request &)
+{}
+
+static void prepare(reader::response &parser)
+{
+    if (parser.code() == http::token::code::status_code)
+        parser.set_method(http::method_id::get);
+}
+
+static void start_line(reader::request &parser, std::ostream &os)
+{
+    using http::token::code;
+
+    if (parser.code() == code::method)
+        os << "method " << parser.value<http::token::method>();
+    else if (parser.code() == code::request_target)
+        os << "target " << parser.value<http::token::request_target>();
+    else
+        os << parser.code();
+}
+
+static void start_line(reader::response &parser, std::ostream &os)
+{
+    using http::token::code;
+
+    if (parser.code() == code::status_code)
+        os << "status " << parser.value<http::token::status_code>();
+    else if (parser.code() == code::reason_phrase)
+        os << "reason " << parser.value<http::token::reason_phrase>();
+    else
+        os << parser.code();
+}
+
+/* Body chunks are merged because their boundaries depend on how the input is
+   split. */
+template<class Parser>
+void record(Parser &parser, std::vector<std::string> &out, std::string &body)
+{
+    using http::token::code;
+    std::ostringstream os;
+
+    switch (parser.code()) {
+    case code::skip:
+        return;
+    case code::body_chunk:
+        {
+            asio::const_buffer b = parser.template value<http::token::body_chunk>();
+            body.append(static_cast<const char*>(b.data()), b.size());
+            return;
+        }
+    case code::field_name:
+    case code::trailer_name:
+        os << "name " << parser.template value<http::token::field_name>();
+        break;
+    case code::field_value:
+    case code::trailer_value:
+        os << "value " << parser.template value<http::token::field_value>();
+        break;
+    case code::chunk_ext:
+        os << "ext "
+           << parser.template value<http::token::chunk_ext>().chunk_size;
+        break;
+    case code::end_of_body:
+        os << "body " << body;
+        body.clear();
+        break;
+    default:
+        start_line(parser, os);
+    }
+
+    out.push_back(os.str());
+}
+
+template<class Parser, class ConstBufferSequence>
+std::vector<std::string> parse(const ConstBufferSequence &buffers)
+{
+    Parser parser;
+    std::vector<std::string> ret;
+    std::string body;
+
+    parser.set_buffer(buffers);
+    while (parser.code() != http::token::code::error_insufficient_data) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+        record(parser, ret, body);
+        prepare(parser);
+        parser.next();
+    }
+
+    return ret;
+}
+
+template<class Parser>
+void check_splits(const std::string &input)
+{
+    std::vector<std::string> expected
+        = parse<Parser>(asio::buffer(input.data(), input.size()));
+    REQUIRE(!expected.empty());
+
+    for (std::size_t i = 0 ; i <= input.size() ; ++i) {
+        for (std::size_t j = i ; j <= input.size() ; j += 5) {
+            INFO("split at " << i << " and " << j);
+            std::vector<asio::const_buffer> buffers;
+            buffers.push_back(asio::buffer(input.data(), i));
+            buffers.push_back(asio::buffer(input.data() + i, j - i));
+            buffers.push_back(asio::buffer(input.data() + j,
+                                           input.size() - j));
+            REQUIRE(parse<Parser>(buffers) == expected);
+        }
+    }
+}
+
+TEST_CASE("Buffer sequences yield the same tokens", "[parser]")
+{
+    check_splits<reader::request>(request_input);
+    check_splits<reader::response>(response_input);
+}
+
+/* A ring buffer never compacts: unparsed bytes at the end of the storage are
+   followed by new bytes written at its beginning. */
+template<class Parser>
+void check_ring(const std::string &input, std::size_t capacity,
+                std::size_t chunk)
+{
+    std::vector<std::string> expected
+        = parse<Parser>(asio::buffer(input.data(), input.size()));
+
+    Parser parser;
+    std::vector<std::string> tokens;
+    std::string body;
+    std::vector<char> ring(capacity);
+    std::size_t head = 0;
+    std::size_t size = 0;
+    std::size_t fed = 0;
+
+    while (fed != input.size()) {
+        std::size_t n = std::min(std::min(chunk, capacity - size),
+                                 input.size() - fed);
+        REQUIRE(n != 0);
+        for (std::size_t i = 0 ; i != n ; ++i)
+            ring[(head + size + i) % capacity] = input[fed + i];
+        size += n;
+        fed += n;
+
+        std::vector<asio::const_buffer> buffers;
+        std::size_t first = std::min(size, capacity - head);
+        buffers.push_back(asio::buffer(&ring[head], first));
+        buffers.push_back(asio::buffer(&ring[0], size - first));
+        parser.set_buffer(buffers);
+
+        while (parser.code() != http::token::code::error_insufficient_data) {
+            REQUIRE(parser.symbol() != http::token::symbol::error);
+            record(parser, tokens, body);
+            prepare(parser);
+            parser.next();
+        }
+
+        head = (head + parser.parsed_count()) % capacity;
+        size -= parser.parsed_count();
+    }
+
+    REQUIRE(tokens == expected);
+}
+
+TEST_CASE("Ring buffer input", "[parser]")
+{
+    const std::size_t chunks[] = { 1, 3, 7, 16, 50 };
+
+    for (std::size_t i = 0 ; i != sizeof(chunks) / sizeof(chunks[0]) ; ++i) {
+        INFO("chunk " << chunks[i]);
+        check_ring<reader::request>(request_input, 64, chunks[i]);
+        check_ring<reader::response>(response_input, 64, chunks[i]);
+    }
+}
+
+TEST_CASE("Single mutable buffers aren't sequences", "[parser]")
+{
+    char input[] = "GET / HTTP/1.1\r\n";
+    reader::request parser;
+
+    parser.set_buffer(asio::buffer(input, sizeof(input) - 1));
+    REQUIRE(parser.code() == http::token::code::method);
+    REQUIRE(parser.value<http::token::method>() == "GET");
+}
+
+TEST_CASE("Body chunks never come from the stitch", "[parser]")
+{
+    const std::string input(request_input);
+    const char *begin = input.data();
+    const char *end = begin + input.size();
+
+    for (std::size_t split = 1 ; split != input.size() ; ++split) {
+        INFO("split " << split);
+        std::vector<asio::const_buffer> buffers;
+        buffers.push_back(asio::buffer(begin, split));
+        buffers.push_back(asio::buffer(begin + split, input.size() - split));
+
+        reader::request parser;
+        parser.set_buffer(buffers);
+        std::string body;
+
+        while (parser.code() != http::token::code::error_insufficient_data) {
+            REQUIRE(parser.symbol() != http::token::symbol::error);
+
+            if (parser.code() == http::token::code::body_chunk) {
+                asio::const_buffer b = parser.value<http::token::body_chunk>();
+                const char *p = static_cast<const char*>(b.data());
+                REQUIRE(p >= begin);
+                REQUIRE(p + b.size() <= end);
+                body.append(p, b.size());
+            }
+
+            parser.next();
+        }
+
+        REQUIRE(parser.parsed_count() == input.size());
+        REQUIRE(body == "pingWiki in\r\n\r\nchunks.");
+    }
+}
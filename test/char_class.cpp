@@ -0,0 +1,110 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include <boost/http/detail/char_class.hpp>
+#include <boost/http/syntax/field_name.hpp>
+#include <boost/http/syntax/field_value.hpp>
+#include <boost/http/syntax/chunk_size.hpp>
+#include <cstring>
+
+namespace http = boost::http;
+namespace detail = http::detail;
+
+// Reference definitions straight from the RFCs
+static bool is_alnum(int c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+        || (c >= '0' && c <= '9');
+}
+
+static bool is_tchar(int c)
+{
+    return is_alnum(c) || (c != 0 && std::strchr("!#$%&'*+-.^_`|~", c));
+}
+
+static bool is_request_target_char(int c)
+{
+    return is_alnum(c) || (c != 0 && std::strchr("?/-._~%!$&'()*+,;=:@", c));
+}
+
+static bool is_vchar(int c)
+{
+    return c >= 0x21 && c <= 0x7E;
+}
+
+static bool is_obs_text(int c)
+{
+    return c >= 0x80 && c <= 0xFF;
+}
+
+static bool is_ows(int c)
+{
+    return c == ' ' || c == '\t';
+}
+
+static bool is_hexdig(int c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F')
+        || (c >= 'a' && c <= 'f');
+}
+
+TEST_CASE("char_class table", "[detail]")
+{
+    for (int c = 0 ; c != 256 ; ++c) {
+        unsigned char ch = static_cast<unsigned char>(c);
+        INFO("byte " << c);
+        REQUIRE(detail::in_class(ch, detail::CHAR_TCHAR) == is_tchar(c));
+        REQUIRE(detail::in_class(ch, detail::CHAR_REQUEST_TARGET)
+                == is_request_target_char(c));
+        REQUIRE(detail::in_class(ch, detail::CHAR_FIELD_VALUE)
+                == (is_ows(c) || is_vchar(c) || is_obs_text(c)));
+        REQUIRE(detail::in_class(ch, detail::CHAR_VCHAR) == is_vchar(c));
+        REQUIRE(detail::in_class(ch, detail::CHAR_OBS_TEXT) == is_obs_text(c));
+        REQUIRE(detail::in_class(ch, detail::CHAR_OWS) == is_ows(c));
+        REQUIRE(detail::in_class(ch, detail::CHAR_DIGIT)
+                == (c >= '0' && c <= '9'));
+        REQUIRE(detail::in_class(ch, detail::CHAR_HEXDIG) == is_hexdig(c));
+    }
+}
+
+TEST_CASE("char_class out of byte range", "[detail]")
+{
+    CHECK(!detail::in_class(static_cast<signed char>(-1),
+                            detail::CHAR_OBS_TEXT));
+    CHECK(!detail::in_class(static_cast<signed char>(-128),
+                            detail::CHAR_FIELD_VALUE));
+    CHECK(!detail::in_class(0x141, detail::CHAR_TCHAR));
+    CHECK(detail::in_class(0x41, detail::CHAR_TCHAR));
+    CHECK(detail::in_class(0xA8, detail::CHAR_OBS_TEXT));
+}
+
+TEST_CASE("char_class find_first_not_of", "[detail]")
+{
+    const unsigned char s[] = "Content-Length: 42";
+    std::size_t n = sizeof(s) - 1;
+
+    CHECK(detail::find_first_not_of(s, n, detail::CHAR_TCHAR) == 14);
+    CHECK(detail::find_first_not_of(s, n, detail::CHAR_FIELD_VALUE) == n);
+    CHECK(detail::find_first_not_of(s + 16, 2, detail::CHAR_DIGIT) == 2);
+    CHECK(detail::find_first_not_of(s, 0, detail::CHAR_TCHAR) == 0);
+}
+
+TEST_CASE("syntax predicates share the table", "[syntax]")
+{
+    namespace sd = http::syntax::detail;
+
+    for (int c = 0 ; c != 256 ; ++c) {
+        unsigned char ch = static_cast<unsigned char>(c);
+        INFO("byte " << c);
+        REQUIRE(sd::is_tchar(ch) == is_tchar(c));
+        REQUIRE(sd::is_hexdigit(ch) == is_hexdig(c));
+        REQUIRE(sd::is_field_value_char(ch)
+                == (is_ows(c) || is_vchar(c) || is_obs_text(c)));
+        // signed `char` never matches obs-text
+        REQUIRE(sd::is_field_value_char(static_cast<char>(c))
+                == (is_ows(c) || is_vchar(c)));
+    }
+}
@@ -4,6 +4,8 @@
 
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
+#include <cstdlib>
+#include <string>
 #include <boost/http/syntax/chunk_size.hpp>
 
 namespace http = boost::http;
@@ -140,3 +142,60 @@ TEST_CASE("from_hex_string", "[syntax]")
     REQUIRE(from_hex_string("00000000005", out) == HEXSTRING_OK);
     REQUIRE(out == 5);
 }
+
+template<class Target>
+void check_against_bytewise(const std::string &in)
+{
+    Target swar = 0;
+    Target bytewise = 0;
+    result r = chunk_size::decode(boost::string_view(in), swar);
+    result expected = syntax::detail::decode_hex_bytewise<char, Target,
+                                                          result>(in,
+                                                                  bytewise);
+
+    // Invalid characters always win over overflow
+    if (in.empty() || in.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+        expected = result::invalid;
+
+    REQUIRE(r == expected);
+    if (r == result::ok)
+        REQUIRE(swar == bytewise);
+}
+
+TEST_CASE("Word at a time decoding", "[syntax]")
+{
+    uint64_t out;
+
+    REQUIRE(chunk_size::decode("ffffffffffffffff", out) == result::ok);
+    REQUIRE(out == UINT64_C(0xFFFFFFFFFFFFFFFF));
+    REQUIRE(chunk_size::decode("00000000000000000FfFfFfFfFfFfFfFf", out)
+            == result::ok);
+    REQUIRE(out == UINT64_C(0xFFFFFFFFFFFFFFFF));
+    REQUIRE(chunk_size::decode("0123456789aBcDeF", out) == result::ok);
+    REQUIRE(out == UINT64_C(0x0123456789ABCDEF));
+    REQUIRE(chunk_size::decode("DeadBeef", out) == result::ok);
+    REQUIRE(out == 0xDEADBEEF);
+    CHECK(chunk_size::decode("10000000000000000", out) == result::overflow);
+    CHECK(chunk_size::decode("1000000000000000000000000000000g", out)
+          == result::invalid);
+    CHECK(chunk_size::decode("1234567G", out) == result::invalid);
+    CHECK(chunk_size::decode("1234567`", out) == result::invalid);
+    CHECK(chunk_size::decode("1234567@", out) == result::invalid);
+    CHECK(chunk_size::decode("12345\xc1" "78", out) == result::invalid);
+
+    const char alphabet[] = "0123456789abcdefABCDEF";
+    std::srand(42);
+    for (int i = 0 ; i != 20000 ; ++i) {
+        std::string in(std::rand() % 8, '0');
+        std::size_t ndigits = std::rand() % 20;
+        for (std::size_t j = 0 ; j != ndigits ; ++j)
+            in += alphabet[std::rand() % 22];
+        if (std::rand() % 4 == 0 && in.size())
+            in[std::rand() % in.size()] = char(std::rand() % 256);
+
+        check_against_bytewise<uint8_t>(in);
+        check_against_bytewise<uint16_t>(in);
+        check_against_bytewise<uint32_t>(in);
+        check_against_bytewise<uint64_t>(in);
+    }
+}
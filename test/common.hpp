@@ -28,6 +28,16 @@ namespace Catch {
             return "error_invalid_transfer_encoding";
         case boost::http::token::code::error_chunk_size_overflow:
             return "error_chunk_size_overflow";
+        case boost::http::token::code::error_request_target_too_long:
+            return "error_request_target_too_long";
+        case boost::http::token::code::error_too_many_fields:
+            return "error_too_many_fields";
+        case boost::http::token::code::error_header_block_too_large:
+            return "error_header_block_too_large";
+        case boost::http::token::code::error_trailer_block_too_large:
+            return "error_trailer_block_too_large";
+        case boost::http::token::code::error_chunk_ext_too_long:
+            return "error_chunk_ext_too_long";
         case boost::http::token::code::field_name:
             return "field_name";
         case boost::http::token::code::field_value:
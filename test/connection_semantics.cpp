@@ -0,0 +1,213 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+typedef http::token::connection_semantics semantics;
+
+/* `value<token::connection_semantics>()` of every message in `input`, fed
+   `chunk` bytes at a time */
+template<class Parser>
+std::vector<unsigned> read_semantics(Parser &parser, const std::string &input,
+                                     std::size_t chunk = 0)
+{
+    using http::token::code;
+
+    std::vector<unsigned> ret;
+    std::string buffer;
+    std::size_t fed = 0;
+
+    if (chunk == 0)
+        chunk = input.size();
+
+    while (fed != input.size()) {
+        std::size_t n = std::min(chunk, input.size() - fed);
+        buffer.append(input, fed, n);
+        fed += n;
+
+        parser.set_buffer(boost::asio::buffer(buffer.data(), buffer.size()));
+
+        while (parser.code() != code::error_insufficient_data) {
+            if (parser.code() == code::error_use_another_connection)
+                return ret;
+
+            REQUIRE(parser.symbol() != http::token::symbol::error);
+
+            if (parser.code() == code::end_of_headers)
+                ret.push_back(parser.template value<semantics>());
+
+            prepare_token(parser);
+            parser.next();
+        }
+
+        buffer.erase(0, parser.parsed_count());
+    }
+
+    return ret;
+}
+
+/* Same as above, but checks that neither trickling the input nor fast framing
+   change the outcome */
+template<class Parser>
+std::vector<unsigned> semantics_of(const std::string &input)
+{
+    Parser parser;
+    std::vector<unsigned> ret = read_semantics(parser, input);
+
+    for (std::size_t chunk = 1 ; chunk != 4 ; ++chunk) {
+        Parser trickled;
+        REQUIRE(read_semantics(trickled, input, chunk) == ret);
+    }
+
+    Parser fast;
+    fast.set_fast_framing(true);
+    fast.set_skip_folding(true);
+    REQUIRE(read_semantics(fast, input) == ret);
+
+    return ret;
+}
+
+template<class Parser>
+unsigned single_semantics(const std::string &input)
+{
+    std::vector<unsigned> ret = semantics_of<Parser>(input);
+    REQUIRE(ret.size() == 1);
+    return ret[0];
+}
+
+TEST_CASE("Request connection semantics", "[connection_semantics]")
+{
+    REQUIRE(single_semantics<reader::request>("GET / HTTP/1.1\r\n"
+                                              "Host: a\r\n\r\n")
+            == semantics::persistent);
+    REQUIRE(single_semantics<reader::request>("GET / HTTP/1.1\r\n"
+                                              "Host: a\r\n"
+                                              "Connection: close\r\n\r\n")
+            == semantics::close);
+    REQUIRE(single_semantics<reader::request>("GET / HTTP/1.0\r\n\r\n") == 0);
+    REQUIRE(single_semantics<reader::request>("GET / HTTP/1.0\r\n"
+                                              "Connection: keep-alive\r\n"
+                                              "\r\n")
+            == (semantics::keep_alive | semantics::persistent));
+
+    // Lists, case and several fields
+    REQUIRE(single_semantics<reader::request>("GET / HTTP/1.0\r\n"
+                                              "Connection: foo ,Keep-Alive\r\n"
+                                              "X-Other: close\r\n"
+                                              "connection: bar, CLOSE\r\n"
+                                              "\r\n")
+            == (semantics::keep_alive | semantics::close));
+    REQUIRE(single_semantics<reader::request>("GET / HTTP/1.1\r\n"
+                                              "Host: a\r\n"
+                                              "Connection: closed, alive\r\n"
+                                              "\r\n")
+            == semantics::persistent);
+
+    REQUIRE(single_semantics<reader::request>("GET /chat HTTP/1.1\r\n"
+                                              "Host: a\r\n"
+                                              "Upgrade: websocket\r\n"
+                                              "Connection: Upgrade\r\n"
+                                              "\r\n")
+            == (semantics::upgrade | semantics::persistent));
+    // Both fields are needed
+    REQUIRE(single_semantics<reader::request>("GET / HTTP/1.1\r\n"
+                                              "Host: a\r\n"
+                                              "Connection: upgrade\r\n"
+                                              "\r\n")
+            == semantics::persistent);
+    REQUIRE(single_semantics<reader::request>("GET / HTTP/1.1\r\n"
+                                              "Host: a\r\n"
+                                              "Upgrade: h2c\r\n"
+                                              "\r\n")
+            == semantics::persistent);
+
+    REQUIRE(single_semantics<reader::request>("PUT / HTTP/1.1\r\n"
+                                              "Host: a\r\n"
+                                              "Content-Length: 0\r\n"
+                                              "Expect: 100-Continue\r\n"
+                                              "\r\n")
+            == (semantics::expect_continue | semantics::persistent));
+    REQUIRE(single_semantics<reader::request>("PUT / HTTP/1.1\r\n"
+                                              "Host: a\r\n"
+                                              "Expect: something-else\r\n"
+                                              "\r\n")
+            == semantics::persistent);
+
+    // Trailers don't count
+    REQUIRE(single_semantics<reader::request>("POST / HTTP/1.1\r\n"
+                                              "Host: a\r\n"
+                                              "Transfer-Encoding: chunked\r\n"
+                                              "\r\n"
+                                              "0\r\n"
+                                              "Connection: close\r\n"
+                                              "\r\n")
+            == semantics::persistent);
+}
+
+TEST_CASE("Every message gets its own semantics", "[connection_semantics]")
+{
+    std::vector<unsigned> ret
+        = semantics_of<reader::request>("GET / HTTP/1.1\r\n"
+                                        "Host: a\r\n"
+                                        "Connection: keep-alive, upgrade\r\n"
+                                        "Upgrade: foo\r\n"
+                                        "Expect: 100-continue\r\n"
+                                        "\r\n"
+                                        "GET / HTTP/1.1\r\n"
+                                        "Host: a\r\n"
+                                        "Connection: close\r\n"
+                                        "\r\n");
+    REQUIRE(ret.size() == 2);
+    REQUIRE(ret[0] == (semantics::keep_alive | semantics::upgrade
+                       | semantics::expect_continue | semantics::persistent));
+    REQUIRE(ret[1] == semantics::close);
+
+    std::string input("GET / HTTP/1.1\r\nConnection: close\r\n");
+    reader::request parser;
+    parser.set_buffer(boost::asio::buffer(input.data(), input.size()));
+    parser.reset();
+    REQUIRE(read_semantics(parser, "GET / HTTP/1.1\r\nHost: a\r\n\r\n")
+            == std::vector<unsigned>(1, semantics::persistent));
+}
+
+TEST_CASE("Response connection semantics", "[connection_semantics]")
+{
+    REQUIRE(single_semantics<reader::response>("HTTP/1.1 200 OK\r\n"
+                                               "Content-Length: 0\r\n"
+                                               "\r\n")
+            == semantics::persistent);
+    REQUIRE(single_semantics<reader::response>("HTTP/1.1 200 OK\r\n"
+                                               "Content-Length: 0\r\n"
+                                               "Connection: close\r\n"
+                                               "\r\n")
+            == semantics::close);
+
+    // The reader stops after these
+    REQUIRE(single_semantics<reader::response>("HTTP/1.1 200 OK\r\n"
+                                               "\r\n")
+            == 0);
+    REQUIRE(single_semantics<reader::response>("HTTP/1.0 200 OK\r\n"
+                                               "Connection: keep-alive\r\n"
+                                               "Content-Length: 0\r\n"
+                                               "\r\n")
+            == semantics::keep_alive);
+
+    REQUIRE(single_semantics<reader::response>("HTTP/1.1 101 Switching"
+                                               " Protocols\r\n"
+                                               "Upgrade: websocket\r\n"
+                                               "Connection: Upgrade\r\n"
+                                               "\r\n")
+            == (semantics::upgrade | semantics::persistent));
+
+    // Only requests carry expectations
+    REQUIRE(single_semantics<reader::response>("HTTP/1.1 204 No Content\r\n"
+                                               "Expect: 100-continue\r\n"
+                                               "\r\n")
+            == semantics::persistent);
+}
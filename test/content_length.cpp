@@ -4,6 +4,8 @@
 
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
+#include <cstdlib>
+#include <string>
 #include <boost/http/syntax/content_length.hpp>
 
 namespace http = boost::http;
@@ -83,3 +85,63 @@ TEST_CASE("from_decimal_string", "[detail]")
     REQUIRE(from_decimal_string("", out) == DECSTRING_INVALID);
     REQUIRE(out == 1);
 }
+
+template<class Target>
+void check_against_bytewise(const std::string &in)
+{
+    Target swar = 0;
+    Target bytewise = 0;
+    result r = content_length::decode(boost::string_view(in), swar);
+    result expected = syntax::detail::decode_decimal_bytewise<char, Target,
+                                                              result>(in,
+                                                                      bytewise);
+
+    // Invalid characters always win over overflow
+    if (in.empty() || in.find_first_not_of("0123456789") != std::string::npos)
+        expected = result::invalid;
+
+    REQUIRE(r == expected);
+    if (r == result::ok)
+        REQUIRE(swar == bytewise);
+}
+
+TEST_CASE("Word at a time decoding", "[detail]")
+{
+    uint64_t out;
+
+    REQUIRE(content_length::decode("18446744073709551615", out) == result::ok);
+    REQUIRE(out == UINT64_C(18446744073709551615));
+    REQUIRE(content_length::decode("0000000000000000000000018446744073709551615",
+                                   out) == result::ok);
+    REQUIRE(out == UINT64_C(18446744073709551615));
+    REQUIRE(content_length::decode("12345678", out) == result::ok);
+    REQUIRE(out == 12345678);
+    REQUIRE(content_length::decode("1234567890123456", out) == result::ok);
+    REQUIRE(out == UINT64_C(1234567890123456));
+    CHECK(content_length::decode("18446744073709551616", out)
+          == result::overflow);
+    CHECK(content_length::decode("99999999999999999999", out)
+          == result::overflow);
+    CHECK(content_length::decode("100000000000000000000", out)
+          == result::overflow);
+    CHECK(content_length::decode("1000000000000000000000000000000a", out)
+          == result::invalid);
+    CHECK(content_length::decode("1234567/", out) == result::invalid);
+    CHECK(content_length::decode("1234567:", out) == result::invalid);
+    CHECK(content_length::decode("12345\xb7" "78", out) == result::invalid);
+
+    std::srand(42);
+    for (int i = 0 ; i != 20000 ; ++i) {
+        std::string in(std::rand() % 8, '0');
+        std::size_t ndigits = std::rand() % 24;
+        for (std::size_t j = 0 ; j != ndigits ; ++j)
+            in += char('0' + std::rand() % 10);
+        if (std::rand() % 4 == 0 && in.size())
+            in[std::rand() % in.size()] = char(std::rand() % 256);
+
+        check_against_bytewise<uint8_t>(in);
+        check_against_bytewise<uint16_t>(in);
+        check_against_bytewise<uint32_t>(in);
+        check_against_bytewise<uint64_t>(in);
+    }
+}
@@ -0,0 +1,109 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/response.hpp>
+#include <limits>
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+template<class Parser>
+void next_until(Parser &parser, http::token::code::value code)
+{
+    while (parser.code() != code) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+        parser.next();
+    }
+}
+
+TEST_CASE("Content-Length body read by the application", "[parser]")
+{
+    reader::request parser;
+    parser.set_buffer(my_buffer("PUT /file HTTP/1.1\r\n"
+                                "Host: a\r\n"
+                                "Content-Length: 1000000\r\n"
+                                "\r\n"
+                                "0123"));
+
+    REQUIRE(parser.body_remaining() == 0);
+    next_until(parser, http::token::code::end_of_headers);
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::body_chunk);
+    REQUIRE(parser.token_size() == 4);
+    REQUIRE(parser.body_remaining() == 1000000 - 4);
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::error_insufficient_data);
+    REQUIRE(parser.expected_token() == http::token::code::body_chunk);
+
+    // The application reads straight from the socket
+    parser.consume_body(500000);
+    REQUIRE(parser.body_remaining() == 1000000 - 4 - 500000);
+    parser.consume_body(1000000 - 4 - 500000);
+    REQUIRE(parser.body_remaining() == 0);
+
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::end_of_body);
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::end_of_message);
+
+    // Pipelined message right after the body
+    parser.set_buffer(my_buffer("GET / HTTP/1.1\r\n"));
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::method);
+    REQUIRE(parser.value<http::token::method>() == "GET");
+}
+
+TEST_CASE("Chunk data read by the application", "[parser]")
+{
+    reader::request parser;
+    parser.set_buffer(my_buffer("POST / HTTP/1.1\r\n"
+                                "Host: a\r\n"
+                                "Transfer-Encoding: chunked\r\n"
+                                "\r\n"
+                                "100000\r\n"));
+
+    next_until(parser, http::token::code::end_of_headers);
+    // chunk-size, chunk-ext and CRLF
+    parser.next();
+    next_until(parser, http::token::code::error_insufficient_data);
+    REQUIRE(parser.expected_token() == http::token::code::body_chunk);
+    REQUIRE(parser.body_remaining() == 0x100000);
+
+    parser.consume_body(0x100000);
+    REQUIRE(parser.body_remaining() == 0);
+
+    parser.set_buffer(my_buffer("\r\n"
+                                "0\r\n"
+                                "\r\n"));
+    next_until(parser, http::token::code::end_of_body);
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::end_of_message);
+}
+
+TEST_CASE("Connection-delimited response body read by the application",
+          "[parser]")
+{
+    reader::response parser;
+    parser.set_buffer(my_buffer("HTTP/1.1 200 OK\r\n"
+                                "\r\n"));
+
+    while (parser.code() != http::token::code::status_code)
+        parser.next();
+    parser.set_method(http::method_id::get);
+    next_until(parser, http::token::code::end_of_headers);
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::error_insufficient_data);
+    REQUIRE(parser.expected_token() == http::token::code::body_chunk);
+    REQUIRE(parser.body_remaining()
+            == std::numeric_limits<boost::uint_least64_t>::max());
+
+    parser.consume_body(12345);
+    parser.puteof();
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::end_of_body);
+}
@@ -0,0 +1,225 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const char request_input[] =
+    "GET /index.html HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+    "Accept: text/html,application/xhtml+xml\r\n"
+    "Accept-Language: en-US,en;q=0.5\r\n"
+    "X-Forwarded-For: 10.0.0.1\r\n"
+    "Cookie: a=b; c=d\r\n"
+    "\r\n"
+
+    "POST /upload HTTP/1.1\r\n"
+    "Content-Length: 4\r\n"
+    "Host: example.com\r\n"
+    "Accept: */*\r\n"
+    "\r\n"
+    "ping"
+
+    "POST / HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "X-Custom: yes\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "4\r\n"
+    "Wiki\r\n"
+    "0\r\n"
+    "\r\n";
+
+static const char response_input[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Server: test\r\n"
+    "Content-Length: 5\r\n"
+    "Cache-Control: no-cache\r\n"
+    "\r\n"
+    "hello"
+
+    "HTTP/1.1 200 OK\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+    "\r\n"
+    "3\r\n"
+    "abc\r\n"
+    "0\r\n"
+    "\r\n";
+
+static bool is_framing(reader::request &, http::field_name_id::value id)
+{
+    return id == http::field_name_id::host
+        || id == http::field_name_id::content_length
+        || id == http::field_name_id::transfer_encoding
+        || id == http::field_name_id::connection
+        || id == http::field_name_id::upgrade
+        || id == http::field_name_id::expect;
+}
+
+static bool is_framing(reader::response &, http::field_name_id::value id)
+{
+    return id == http::field_name_id::content_length
+        || id == http::field_name_id::transfer_encoding
+        || id == http::field_name_id::connection
+        || id == http::field_name_id::upgrade;
+}
+
+/* Tokens of the fully validating reader that remain visible in fast framing
+   mode (`skip` tokens excluded) */
+template<class Parser>
+std::vector<recorded_token> visible_tokens(const std::string &input,
+                                         const reader::field_filter *filter)
+{
+    using http::token::code;
+
+    Parser parser;
+    std::vector<recorded_token> ret;
+    bool visible = true;
+
+    parser.set_buffer(asio::buffer(input.data(), input.size()));
+    while (parser.code() != code::error_insufficient_data) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+
+        if (parser.code() == code::field_name) {
+            http::field_name_id::value id
+                = parser.template value<http::token::field_name_id>();
+            visible = filter ? filter->contains(id) : is_framing(parser, id);
+        }
+
+        if ((parser.code() != code::field_name
+             && parser.code() != code::field_value) || visible) {
+            if (parser.code() != code::skip) {
+                recorded_token t = {
+                    parser.code(),
+                    parser.token_size(),
+                    parser.parsed_count()
+                };
+                ret.push_back(t);
+            }
+        }
+
+        prepare_token(parser);
+        parser.next();
+    }
+
+    return ret;
+}
+
+template<class Parser>
+void check_fast_framing(const std::string &input,
+                        const reader::field_filter *filter)
+{
+    Parser parser;
+    parser.set_fast_framing(true);
+    parser.set_skip_folding(true);
+    parser.set_field_filter(filter);
+
+    REQUIRE(read_tokens(parser, input)
+            == visible_tokens<Parser>(input, filter));
+    REQUIRE(parser.parsed_count() == input.size());
+
+    // Field tokens don't depend on how the input is split
+    const std::size_t chunks[] = { 1, 3, 64 };
+    for (std::size_t i = 0 ; i != sizeof(chunks) / sizeof(chunks[0]) ; ++i) {
+        INFO("chunk size " << chunks[i]);
+        Parser whole;
+        Parser split;
+        whole.set_fast_framing(true);
+        split.set_fast_framing(true);
+        whole.set_field_filter(filter);
+        split.set_field_filter(filter);
+
+        std::vector<recorded_token> a = read_tokens(whole, input);
+        std::vector<recorded_token> b = read_tokens(split, input, chunks[i]);
+        std::vector<recorded_token> fields_a;
+        std::vector<recorded_token> fields_b;
+        for (std::size_t j = 0 ; j != a.size() ; ++j) {
+            if (a[j].code == http::token::code::field_name
+                || a[j].code == http::token::code::field_value) {
+                fields_a.push_back(a[j]);
+            }
+        }
+        for (std::size_t j = 0 ; j != b.size() ; ++j) {
+            if (b[j].code == http::token::code::field_name
+                || b[j].code == http::token::code::field_value) {
+                fields_b.push_back(b[j]);
+            }
+        }
+        REQUIRE(fields_a == fields_b);
+    }
+}
+
+TEST_CASE("Fast framing keeps the framing fields", "[fast_framing]")
+{
+    check_fast_framing<reader::request>(request_input, NULL);
+    check_fast_framing<reader::response>(response_input, NULL);
+}
+
+TEST_CASE("Fast framing keeps the routing fields", "[fast_framing]")
+{
+    reader::field_filter filter;
+    filter.insert(http::field_name_id::host);
+    filter.insert(http::field_name_id::cookie);
+    filter.insert(http::field_name_id::unknown);
+    check_fast_framing<reader::request>(request_input, &filter);
+
+    reader::field_filter response_filter;
+    response_filter.insert(http::field_name_id::server);
+    check_fast_framing<reader::response>(response_input, &response_filter);
+}
+
+TEST_CASE("Fast framing doesn't validate skipped lines", "[fast_framing]")
+{
+    const char input[] = "GET / HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "User-Agent: \x01\x7F\r\n"
+        "\r\n";
+
+    reader::request validating;
+    std::vector<recorded_token> tokens
+        = read_tokens(validating, std::string(input));
+    REQUIRE(tokens.back().code == http::token::code::error_invalid_data);
+
+    reader::request fast;
+    fast.set_fast_framing(true);
+    tokens = read_tokens(fast, std::string(input));
+    REQUIRE(tokens.back().code == http::token::code::end_of_message);
+    REQUIRE(fast.parsed_count() == sizeof(input) - 1);
+}
+
+TEST_CASE("Fast framing releases long skipped lines", "[fast_framing]")
+{
+    std::string input = "GET / HTTP/1.1\r\nHost: example.com\r\nCookie: ";
+    input.append(10000, 'c');
+    input += "\r\n\r\n";
+
+    reader::request parser;
+    parser.set_fast_framing(true);
+
+    std::string buffer;
+    std::size_t largest = 0;
+    for (std::size_t fed = 0 ; fed != input.size() ; ) {
+        std::size_t n = std::min<std::size_t>(100, input.size() - fed);
+        buffer.append(input, fed, n);
+        fed += n;
+        largest = std::max(largest, buffer.size());
+
+        parser.set_buffer(asio::buffer(buffer.data(), buffer.size()));
+        while (parser.code() != http::token::code::error_insufficient_data) {
+            REQUIRE(parser.symbol() != http::token::symbol::error);
+            parser.next();
+        }
+        buffer.erase(0, parser.parsed_count());
+    }
+
+    REQUIRE(buffer.empty());
+    REQUIRE(largest < 200);
+}
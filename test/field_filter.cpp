@@ -0,0 +1,206 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+#include <boost/http/reader/field_filter.hpp>
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const char request_input[] =
+    "GET / HTTP/1.1\r\n"
+    "host: aliceinthewonderland.com\r\n"
+    "User-Agent: curl\r\n"
+    "X-Custom: yes\r\n"
+    "Accept: */*\r\n"
+    "\r\n"
+
+    "POST /upload HTTP/1.1\r\n"
+    "Content-length: 4\r\n"
+    "Accept: text/html\r\n"
+    "host:thelastringbearer.org\r\n"
+    "\r\n"
+    "ping"
+
+    "POST / HTTP/1.1\r\n"
+    "Host: playwithme.onion\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "Cookie: a=b\r\n"
+    "\r\n"
+    "4\r\n"
+    "Wiki\r\n"
+    "0\r\n"
+    "Content-MD5: 25b83662323c397c9944a8a7b3fef7ab\r\n"
+    "Cookie: c=d\r\n"
+    "\r\n";
+
+static const char response_input[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 5\r\n"
+    "Server: test\r\n"
+    "Cache-Control: no-cache\r\n"
+    "\r\n"
+    "hello";
+
+// Tokens of `parser` without the fields that `filter` hides
+template<class Parser>
+std::vector<recorded_token> filtered_tokens(const std::string &input,
+                                          const reader::field_filter &filter)
+{
+    using http::token::code;
+
+    Parser parser;
+    std::vector<recorded_token> ret;
+    bool drop = false;
+
+    parser.set_buffer(asio::buffer(input.data(), input.size()));
+    while (parser.code() != code::error_insufficient_data) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+
+        if (parser.code() == code::field_name
+            || parser.code() == code::trailer_name) {
+            drop = !filter.contains(parser.template value<
+                                    http::token::field_name_id>());
+        }
+
+        bool field = parser.code() == code::field_name
+            || parser.code() == code::field_value
+            || parser.code() == code::trailer_name
+            || parser.code() == code::trailer_value;
+
+        if (!field || !drop) {
+            recorded_token t = {
+                parser.code(),
+                parser.token_size(),
+                parser.parsed_count()
+            };
+            ret.push_back(t);
+        }
+
+        prepare_token(parser);
+        parser.next();
+    }
+
+    return ret;
+}
+
+template<class Parser>
+void check_filter(const std::string &input, const reader::field_filter &filter)
+{
+    const std::size_t chunks[] = { 0, 1, 3, 64 };
+    std::vector<recorded_token> expected
+        = filtered_tokens<Parser>(input, filter);
+
+    for (std::size_t i = 0 ; i != sizeof(chunks) / sizeof(chunks[0]) ; ++i) {
+        INFO("chunk size " << chunks[i]);
+        Parser parser;
+        parser.set_field_filter(&filter);
+        std::vector<recorded_token> tokens = read_tokens(parser, input,
+                                                       chunks[i]);
+        if (chunks[i] == 0)
+            REQUIRE(tokens == expected);
+
+        // Body chunks depend on the chunk size, but fields don't
+        for (std::size_t j = 0 ; j != tokens.size() ; ++j) {
+            if (tokens[j].code != http::token::code::field_name
+                && tokens[j].code != http::token::code::trailer_name) {
+                continue;
+            }
+            REQUIRE(std::find(expected.begin(), expected.end(), tokens[j])
+                    != expected.end());
+        }
+    }
+}
+
+TEST_CASE("Field filter sets", "[field_filter]")
+{
+    reader::field_filter filter;
+    REQUIRE(!filter.contains(http::field_name_id::unknown));
+    REQUIRE(!filter.contains(http::field_name_id::host));
+
+    filter.insert(http::field_name_id::host);
+    filter.insert(http::field_name_id::x_frame_options);
+    filter.insert("User-Agent");
+    REQUIRE(filter.contains(http::field_name_id::host));
+    REQUIRE(filter.contains(http::field_name_id::x_frame_options));
+    REQUIRE(filter.contains(http::field_name_id::user_agent));
+    REQUIRE(!filter.contains(http::field_name_id::unknown));
+
+    filter.insert("X-Whatever");
+    REQUIRE(filter.contains(http::field_name_id::unknown));
+
+    filter.erase(http::field_name_id::host);
+    REQUIRE(!filter.contains(http::field_name_id::host));
+    REQUIRE(filter.contains(http::field_name_id::x_frame_options));
+}
+
+TEST_CASE("Filtered request fields", "[field_filter]")
+{
+    reader::field_filter filter;
+    check_filter<reader::request>(request_input, filter);
+
+    filter.insert(http::field_name_id::accept);
+    check_filter<reader::request>(request_input, filter);
+
+    filter.insert(http::field_name_id::unknown);
+    filter.insert(http::field_name_id::cookie);
+    check_filter<reader::request>(request_input, filter);
+}
+
+TEST_CASE("Filtered response fields", "[field_filter]")
+{
+    reader::field_filter filter;
+    check_filter<reader::response>(response_input, filter);
+
+    filter.insert(http::field_name_id::server);
+    check_filter<reader::response>(response_input, filter);
+}
+
+TEST_CASE("Hidden fields still frame the message", "[field_filter]")
+{
+    using http::token::code;
+
+    reader::field_filter filter;
+    filter.insert(http::field_name_id::accept);
+
+    reader::request parser;
+    parser.set_field_filter(&filter);
+    parser.set_skip_folding(true);
+
+    const std::string input = request_input;
+    std::vector<recorded_token> tokens = read_tokens(parser, input);
+
+    const code::value expected[] = {
+        code::method, code::request_target, code::version,
+        code::field_name, code::field_value, code::end_of_headers,
+        code::end_of_body, code::end_of_message,
+
+        code::method, code::request_target, code::version,
+        code::field_name, code::field_value, code::end_of_headers,
+        code::body_chunk, code::end_of_body, code::end_of_message,
+
+        code::method, code::request_target, code::version,
+        code::end_of_headers, code::body_chunk, code::end_of_body,
+        code::end_of_message
+    };
+    REQUIRE(tokens.size() == sizeof(expected) / sizeof(expected[0]));
+    for (std::size_t i = 0 ; i != tokens.size() ; ++i) {
+        INFO("token " << i);
+        REQUIRE(tokens[i].code == expected[i]);
+    }
+    REQUIRE(parser.parsed_count() == input.size());
+
+    // Host is still required even when hidden
+    const char no_host[] = "GET / HTTP/1.1\r\nAccept: */*\r\n\r\n";
+    parser.reset();
+    parser.set_buffer(asio::buffer(no_host, sizeof(no_host) - 1));
+    while (parser.code() != code::error_insufficient_data
+           && parser.symbol() != http::token::symbol::error) {
+        parser.next();
+    }
+    REQUIRE(parser.code() == code::error_no_host);
+}
@@ -0,0 +1,106 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include <boost/http/field_name_id.hpp>
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/response.hpp>
+#include <string>
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+typedef http::field_name_id id;
+
+TEST_CASE("Every registered name is classified", "[field_name_id]")
+{
+    for (int i = id::unknown + 1 ; i <= id::x_frame_options ; ++i) {
+        id::value v = static_cast<id::value>(i);
+        std::string name(id::name(v).data(), id::name(v).size());
+        INFO(name);
+
+        REQUIRE(!name.empty());
+        REQUIRE(id::classify(name) == v);
+
+        std::string upper(name);
+        for (std::size_t j = 0 ; j != upper.size() ; ++j) {
+            if (upper[j] >= 'a' && upper[j] <= 'z')
+                upper[j] -= 0x20;
+        }
+        REQUIRE(id::classify(upper) == v);
+
+        REQUIRE(id::classify(name + 'x') == id::unknown);
+        REQUIRE(id::classify(name.substr(0, name.size() - 1)) == id::unknown);
+    }
+}
+
+TEST_CASE("Unregistered names are unknown", "[field_name_id]")
+{
+    CHECK(id::classify("") == id::unknown);
+    CHECK(id::classify("H") == id::unknown);
+    CHECK(id::classify("X-Pants") == id::unknown);
+    CHECK(id::classify("Hosu") == id::unknown);
+    CHECK(id::classify("Content_Length") == id::unknown);
+    CHECK(id::classify(boost::string_view("Ho\0t", 4)) == id::unknown);
+    CHECK(id::classify(boost::string_view("\0\0", 2)) == id::unknown);
+    CHECK(id::classify("Content-Length") == id::content_length);
+    CHECK(id::classify("wWw-aUtHeNtIcAtE") == id::www_authenticate);
+    CHECK(id::name(id::unknown).empty());
+}
+
+TEST_CASE("Readers expose the field name id", "[parser,field_name_id]")
+{
+    {
+        reader::request parser;
+        parser.set_buffer(my_buffer("POST / HTTP/1.1\r\n"
+                                    "hOsT: example.com\r\n"
+                                    "X-Pants: On\r\n"
+                                    "Transfer-Encoding: chunked\r\n"
+                                    "\r\n"
+                                    "0\r\n"
+                                    "Content-MD5: 42\r\n"
+                                    "\r\n"));
+        id::value expected[] = {
+            id::host, id::unknown, id::transfer_encoding, id::content_md5
+        };
+        std::size_t n = 0;
+
+        while (parser.code() != http::token::code::end_of_message) {
+            REQUIRE(parser.code() != http::token::code::error_insufficient_data);
+            if (parser.code() == http::token::code::field_name
+                || parser.code() == http::token::code::trailer_name) {
+                REQUIRE(n < sizeof(expected) / sizeof(expected[0]));
+                REQUIRE(parser.value<http::token::field_name_id>()
+                        == expected[n++]);
+            }
+            parser.next();
+        }
+        REQUIRE(n == sizeof(expected) / sizeof(expected[0]));
+    }
+
+    {
+        reader::response parser;
+        parser.set_buffer(my_buffer("HTTP/1.1 200 OK\r\n"
+                                    "Content-Length: 0\r\n"
+                                    "Server: x\r\n"
+                                    "\r\n"));
+        id::value expected[] = { id::content_length, id::server };
+        std::size_t n = 0;
+
+        while (parser.code() != http::token::code::end_of_message) {
+            REQUIRE(parser.code() != http::token::code::error_insufficient_data);
+            if (parser.code() == http::token::code::status_code)
+                parser.set_method("GET");
+            if (parser.code() == http::token::code::field_name) {
+                REQUIRE(n < sizeof(expected) / sizeof(expected[0]));
+                REQUIRE(parser.value<http::token::field_name_id>()
+                        == expected[n++]);
+            }
+            parser.next();
+        }
+        REQUIRE(n == sizeof(expected) / sizeof(expected[0]));
+    }
+}
@@ -0,0 +1,135 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+#include <boost/http/header_map.hpp>
+#include <sstream>
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+TEST_CASE("Header map lookups", "[header_map]")
+{
+    http::header_map map;
+    REQUIRE(map.empty());
+    REQUIRE(map.find("host") == map.size());
+    REQUIRE(map.get("host").empty());
+
+    map.insert("Host", "example.com");
+    map.insert("Accept", "text/html");
+    map.insert("X-Custom", "");
+    map.insert("ACCEPT", "text/plain");
+    map.insert("accept", "*/*");
+
+    REQUIRE(map.size() == 5);
+    REQUIRE(map.name(3) == "ACCEPT");
+    REQUIRE(map.value(3) == "text/plain");
+    REQUIRE(map.get("HOST") == "example.com");
+    REQUIRE(map.get("x-custom").empty());
+    REQUIRE(map.find("x-custom") == 2);
+    REQUIRE(map.count("x-custom") == 1);
+    REQUIRE(map.count("missing") == 0);
+
+    // Duplicates are chained in order
+    REQUIRE(map.count("Accept") == 3);
+    std::size_t i = map.find("accept");
+    REQUIRE(i == 1);
+    i = map.find_next(i);
+    REQUIRE(i == 3);
+    i = map.find_next(i);
+    REQUIRE(i == 4);
+    REQUIRE(map.find_next(i) == map.size());
+
+    // Names differing on non-letters are different
+    REQUIRE(map.find("x_custom") == map.size());
+    REQUIRE(map.find("hosts") == map.size());
+}
+
+TEST_CASE("Header map growth", "[header_map]")
+{
+    http::header_map map;
+    for (int round = 0 ; round != 2 ; ++round) {
+        for (int i = 0 ; i != 300 ; ++i) {
+            std::ostringstream name, value;
+            name << "X-Field-" << (i % 100);
+            value << i;
+            map.insert(name.str(), value.str());
+        }
+
+        REQUIRE(map.size() == 300);
+        for (int i = 0 ; i != 100 ; ++i) {
+            std::ostringstream name, value;
+            name << "x-field-" << i;
+            value << i;
+            REQUIRE(map.get(name.str()) == value.str());
+            REQUIRE(map.count(name.str()) == 3);
+        }
+
+        map.clear();
+        REQUIRE(map.empty());
+        REQUIRE(map.find("x-field-1") == 0);
+    }
+}
+
+TEST_CASE("Header map from reader tokens", "[header_map]")
+{
+    std::string input("GET / HTTP/1.1\r\n"
+                      "Host: example.com\r\n"
+                      "Cookie: a=1 \r\n"
+                      "Cookie: b=2\r\n"
+                      "\r\n"
+                      "GET /other HTTP/1.1\r\n"
+                      "Host: other.com\r\n"
+                      "\r\n");
+
+    http::header_map map;
+    reader::request parser;
+    parser.set_buffer(boost::asio::buffer(input.data(), input.size()));
+
+    // Capacity reached by the first message
+    std::size_t first_fields = 0;
+    const char *first_name = NULL;
+    int nmessages = 0;
+
+    while (parser.code() != http::token::code::error_insufficient_data) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+
+        if (parser.code() == http::token::code::method)
+            map.clear();
+
+        map.record(parser);
+
+        if (parser.code() == http::token::code::end_of_headers) {
+            if (nmessages == 0) {
+                REQUIRE(map.size() == 3);
+                REQUIRE(map.get("host") == "example.com");
+                REQUIRE(map.count("cookie") == 2);
+                REQUIRE(map.value(1) == "a=1");
+                REQUIRE(map.value(map.find_next(1)) == "b=2");
+                first_fields = map.size();
+                first_name = map.name(0).data();
+            } else {
+                REQUIRE(map.size() == 1);
+                REQUIRE(map.get("Host") == "other.com");
+                REQUIRE(map.find("cookie") == map.size());
+                // Memory from the first message is reused
+                REQUIRE(map.name(0).data() == first_name);
+            }
+        } else if (parser.code() == http::token::code::end_of_message) {
+            ++nmessages;
+        }
+
+        parser.next();
+    }
+
+    REQUIRE(nmessages == 2);
+    REQUIRE(first_fields == 3);
+
+    // The copies don't depend on the input
+    std::fill(input.begin(), input.end(), 'x');
+    REQUIRE(map.get("host") == "other.com");
+}
@@ -0,0 +1,274 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+#include <boost/http/reader/input_buffer.hpp>
+#include <cstring>
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+using http::token::code;
+
+TEST_CASE("Input buffer keeps unread bytes first", "[input_buffer]")
+{
+    reader::input_buffer_pool pool(16);
+    reader::input_buffer buffer;
+    REQUIRE(buffer.capacity() == 0);
+
+    pool.attach(buffer);
+    REQUIRE(buffer.capacity() == 16);
+    REQUIRE(buffer.size() == 0);
+    REQUIRE(asio::buffer_size(buffer.prepare()) == 16);
+
+    asio::mutable_buffer free_space = buffer.prepare();
+    std::memcpy(free_space.data(), "0123456789", 10);
+    buffer.commit(10);
+    buffer.consume(6);
+    REQUIRE(buffer.size() == 4);
+    REQUIRE(std::memcmp(buffer.data().data(), "6789", 4) == 0);
+
+    // The unread bytes move to the front, so the whole free space follows them
+    free_space = buffer.prepare();
+    REQUIRE(free_space.size() == 12);
+    REQUIRE(buffer.data().data() == static_cast<const void*>(
+                static_cast<const char*>(free_space.data()) - 4));
+    REQUIRE(std::memcmp(buffer.data().data(), "6789", 4) == 0);
+
+    // Attaching again changes nothing
+    const void *storage = buffer.data().data();
+    pool.attach(buffer);
+    REQUIRE(buffer.data().data() == storage);
+    REQUIRE(buffer.size() == 4);
+
+    // Unread bytes keep the storage attached
+    REQUIRE_FALSE(pool.detach(buffer));
+    REQUIRE(buffer.capacity() == 16);
+
+    buffer.consume(4);
+    REQUIRE(pool.detach(buffer));
+    REQUIRE(buffer.capacity() == 0);
+    REQUIRE(pool.cached() == 1);
+
+    // Storage is reused
+    reader::input_buffer other;
+    pool.attach(other);
+    REQUIRE(pool.cached() == 0);
+    REQUIRE(other.data().data() == storage);
+}
+
+TEST_CASE("Input buffer pool bounds its cache", "[input_buffer]")
+{
+    reader::input_buffer_pool pool(64, 2);
+    reader::input_buffer buffers[4];
+
+    for (std::size_t i = 0 ; i != 4 ; ++i)
+        pool.attach(buffers[i]);
+    REQUIRE(pool.cached() == 0);
+
+    for (std::size_t i = 0 ; i != 4 ; ++i)
+        REQUIRE(pool.detach(buffers[i]));
+    REQUIRE(pool.cached() == 2);
+
+    // Detaching a buffer without storage is harmless
+    REQUIRE(pool.detach(buffers[0]));
+    REQUIRE(pool.cached() == 2);
+}
+
+static std::string keep_alive_requests()
+{
+    std::string ret;
+    for (int i = 0 ; i != 20 ; ++i) {
+        ret += "POST /upload HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "X-Counter: ";
+        ret += char('a' + i % 26);
+        ret += "\r\n"
+            "Content-Length: 11\r\n"
+            "\r\n"
+            "hello world";
+    }
+    return ret;
+}
+
+TEST_CASE("Idle connections give their buffers back", "[input_buffer]")
+{
+    const std::string input = keep_alive_requests();
+
+    for (std::size_t chunk = 1 ; chunk < 70 ; chunk += 7) {
+        reader::request dedicated;
+        std::vector<recorded_token> expected
+            = read_tokens(dedicated, input, chunk);
+        REQUIRE(expected.back().code == code::end_of_message);
+
+        reader::input_buffer_pool pool(256);
+        reader::input_buffer buffer;
+        reader::request parser;
+        std::vector<recorded_token> tokens;
+        std::size_t released = 0;
+        std::size_t detached = 0;
+
+        for (std::size_t fed = 0 ; fed != input.size() ;) {
+            // The connection is readable
+            pool.attach(buffer);
+            asio::mutable_buffer free_space = buffer.prepare();
+            std::size_t n = std::min(std::min(chunk, free_space.size()),
+                                     input.size() - fed);
+            std::memcpy(free_space.data(), input.data() + fed, n);
+            buffer.commit(n);
+            fed += n;
+
+            parser.set_buffer(buffer.data());
+            bool message_ended = false;
+            while (parser.code() != code::error_insufficient_data) {
+                recorded_token t = {
+                    parser.code(),
+                    parser.token_size(),
+                    released + parser.parsed_count()
+                };
+                tokens.push_back(t);
+                message_ended = parser.code() == code::end_of_message;
+                parser.next();
+            }
+
+            released += parser.parsed_count();
+            buffer.consume(parser.parsed_count());
+
+            // Idle at a message boundary
+            if (message_ended && pool.detach(buffer)) {
+                REQUIRE(buffer.capacity() == 0);
+                ++detached;
+            }
+        }
+
+        REQUIRE(tokens == expected);
+        REQUIRE(detached > 0);
+    }
+}
+
+/* Serves `input` through a buffer of `pool` that grows as told by the pool,
+   `chunk` bytes at a time. Returns the largest capacity seen (or 0 if a token
+   doesn't fit). `capacities` receives the capacity after each round that
+   ended a message. */
+static std::size_t serve_growing(reader::input_buffer_pool &pool,
+                                 const std::string &input, std::size_t chunk,
+                                 std::vector<std::size_t> &capacities,
+                                 std::string &body)
+{
+    reader::input_buffer buffer;
+    reader::request parser;
+    std::size_t largest = 0;
+
+    pool.attach(buffer);
+    for (std::size_t fed = 0 ; fed != input.size() ;) {
+        asio::mutable_buffer free_space = buffer.prepare();
+        std::size_t n = std::min(std::min(chunk, free_space.size()),
+                                 input.size() - fed);
+        std::memcpy(free_space.data(), input.data() + fed, n);
+        buffer.commit(n);
+        fed += n;
+        largest = std::max(largest, buffer.capacity());
+
+        parser.set_buffer(buffer.data());
+        bool message_ended = false;
+        while (parser.code() != code::error_insufficient_data) {
+            REQUIRE(parser.symbol() != http::token::symbol::error);
+
+            if (parser.code() == code::end_of_message)
+                message_ended = true;
+
+            if (parser.code() == code::body_chunk) {
+                asio::const_buffer b
+                    = parser.value<http::token::body_chunk>();
+                body.append(static_cast<const char*>(b.data()), b.size());
+            }
+
+            parser.next();
+        }
+
+        buffer.consume(parser.parsed_count());
+
+        if (message_ended) {
+            pool.shrink(buffer);
+            capacities.push_back(buffer.capacity());
+        } else if (!pool.grow(buffer, parser)) {
+            return 0;
+        }
+    }
+
+    return largest;
+}
+
+TEST_CASE("Input buffers grow for header blocks only", "[input_buffer]")
+{
+    reader::buffer_growth growth(64, 512);
+    reader::input_buffer_pool pool(growth);
+    REQUIRE(pool.buffer_size() == 64);
+    REQUIRE(pool.max_buffer_size() == 512);
+
+    std::string cookie(200, 'c');
+    std::string large_body(3000, 'b');
+    std::string input = "GET / HTTP/1.1\r\n"
+        "Host: a\r\n"
+        "Cookie: " + cookie + "\r\n"
+        "\r\n"
+        "POST / HTTP/1.1\r\n"
+        "Host: a\r\n"
+        "Content-Length: 3000\r\n"
+        "\r\n" + large_body;
+
+    for (std::size_t chunk = 16 ; chunk <= 1024 ; chunk *= 4) {
+        std::vector<std::size_t> capacities;
+        std::string body;
+        std::size_t largest = serve_growing(pool, input, chunk, capacities,
+                                            body);
+
+        // The cookie line needs 256 bytes, the body never needs more room
+        REQUIRE(largest == 256);
+        REQUIRE(body == large_body);
+        REQUIRE(capacities.size() >= 1);
+        for (std::size_t i = 0 ; i != capacities.size() ; ++i)
+            REQUIRE(capacities[i] == 64);
+    }
+
+    // Grown storage is reused
+    REQUIRE(pool.cached() >= 2);
+}
+
+TEST_CASE("Input buffers stop growing at the limit", "[input_buffer]")
+{
+    reader::input_buffer_pool pool(reader::buffer_growth(64, 300));
+
+    std::string input = "GET / HTTP/1.1\r\n"
+        "Host: a\r\n"
+        "Cookie: " + std::string(320, 'c') + "\r\n"
+        "\r\n";
+    std::vector<std::size_t> capacities;
+    std::string body;
+    REQUIRE(serve_growing(pool, input, 50, capacities, body) == 0);
+
+    // 64, 128, 256 and the limit
+    input = "GET / HTTP/1.1\r\n"
+        "Host: a\r\n"
+        "Cookie: " + std::string(270, 'c') + "\r\n"
+        "\r\n";
+    REQUIRE(serve_growing(pool, input, 50, capacities, body) == 300);
+}
+
+TEST_CASE("Fixed input buffers never grow", "[input_buffer]")
+{
+    reader::input_buffer_pool pool(64);
+    REQUIRE(pool.max_buffer_size() == 64);
+
+    std::string input = "GET / HTTP/1.1\r\n"
+        "Host: a\r\n"
+        "Cookie: " + std::string(100, 'c') + "\r\n"
+        "\r\n";
+    std::vector<std::size_t> capacities;
+    std::string body;
+    REQUIRE(serve_growing(pool, input, 50, capacities, body) == 0);
+}
@@ -0,0 +1,210 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const char request_input[] =
+    "GET /index.html HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+    "Accept: text/html\r\n"
+    "\r\n"
+
+    "POST /upload HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "4;name=value\r\n"
+    "Wiki\r\n"
+    "0\r\n"
+    "Expires: never\r\n"
+    "\r\n";
+
+// Size of the header block of the first message of `request_input`
+static const std::size_t first_header_block = 26 + 19 + 44 + 20 + 2;
+
+static const char response_input[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Server: test\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "3;a=b\r\n"
+    "abc\r\n"
+    "0\r\n"
+    "Expires: never\r\n"
+    "\r\n";
+
+/* Token stream for `input` read `chunk` bytes at a time under `policy`.
+   Readers are checked with and without skip folding and fast framing (they
+   mustn't change the outcome). */
+template<class Parser>
+std::vector<recorded_token> read_limited(const std::string &input,
+                                       const reader::limits &policy,
+                                       std::size_t chunk = 0)
+{
+    Parser parser;
+    parser.set_limits(&policy);
+    std::vector<recorded_token> ret = read_tokens(parser, input, chunk);
+
+    Parser fast;
+    fast.set_limits(&policy);
+    fast.set_skip_folding(true);
+    fast.set_fast_framing(true);
+    std::vector<recorded_token> fast_ret = read_tokens(fast, input, chunk);
+
+    REQUIRE(ret.size());
+    REQUIRE(fast_ret.size());
+    REQUIRE(ret.back().code == fast_ret.back().code);
+
+    return ret;
+}
+
+TEST_CASE("Limits that aren't reached change nothing", "[limits]")
+{
+    std::string input(request_input);
+
+    reader::limits policy;
+    policy.max_fields = 3;
+    policy.max_header_bytes = first_header_block;
+    policy.max_target_size = 11;
+    policy.max_trailer_bytes = 18;
+    policy.max_chunk_ext_size = 11;
+
+    for (std::size_t chunk = 0 ; chunk != 8 ; ++chunk) {
+        reader::request plain;
+        reader::request parser;
+        parser.set_limits(&policy);
+        REQUIRE(read_tokens(parser, input, chunk)
+                == read_tokens(plain, input, chunk));
+    }
+
+    // Disabling limits again
+    reader::limits tight;
+    tight.max_fields = 0;
+    reader::request plain;
+    reader::request parser;
+    parser.set_limits(&tight);
+    parser.set_limits(NULL);
+    REQUIRE(read_tokens(parser, input) == read_tokens(plain, input));
+}
+
+TEST_CASE("Request-target limit", "[limits]")
+{
+    reader::limits policy;
+    policy.max_target_size = 10;
+
+    for (std::size_t chunk = 0 ; chunk != 4 ; ++chunk) {
+        std::vector<recorded_token> tokens
+            = read_limited<reader::request>(request_input, policy, chunk);
+        REQUIRE(tokens.back().code
+                == http::token::code::error_request_target_too_long);
+        // Detected before the whole target arrives
+        if (chunk == 1)
+            REQUIRE(tokens.back().offset <= 4);
+    }
+}
+
+TEST_CASE("Field count limit", "[limits]")
+{
+    reader::limits policy;
+    policy.max_fields = 2;
+
+    std::vector<recorded_token> tokens
+        = read_limited<reader::request>(request_input, policy);
+    REQUIRE(tokens.back().code == http::token::code::error_too_many_fields);
+
+    // Fields are counted again for every message
+    policy.max_fields = 3;
+    tokens = read_limited<reader::request>(request_input, policy);
+    REQUIRE(tokens.back().code == http::token::code::end_of_message);
+    REQUIRE(tokens.back().offset + tokens.back().size
+            == sizeof(request_input) - 1);
+}
+
+TEST_CASE("Header block limit", "[limits]")
+{
+    reader::limits policy;
+    policy.max_header_bytes = first_header_block - 1;
+
+    for (std::size_t chunk = 0 ; chunk != 4 ; ++chunk) {
+        std::vector<recorded_token> tokens
+            = read_limited<reader::request>(request_input, policy, chunk);
+        REQUIRE(tokens.back().code
+                == http::token::code::error_header_block_too_large);
+    }
+
+    // A long field value is caught while it's still being received
+    std::string input("GET / HTTP/1.1\r\nHost: a\r\nCookie: ");
+    input.append(1000, 'x');
+    input.append("\r\n\r\n");
+    policy.max_header_bytes = 100;
+    std::vector<recorded_token> tokens
+        = read_limited<reader::request>(input, policy, 1);
+    REQUIRE(tokens.back().code
+            == http::token::code::error_header_block_too_large);
+    REQUIRE(tokens.back().offset <= 100);
+
+    tokens = read_limited<reader::response>(response_input, policy);
+    REQUIRE(tokens.back().code == http::token::code::end_of_message);
+    policy.max_header_bytes = 30;
+    tokens = read_limited<reader::response>(response_input, policy);
+    REQUIRE(tokens.back().code
+            == http::token::code::error_header_block_too_large);
+}
+
+TEST_CASE("Trailer block limit", "[limits]")
+{
+    reader::limits policy;
+    policy.max_trailer_bytes = 17;
+
+    std::vector<recorded_token> tokens
+        = read_limited<reader::request>(request_input, policy);
+    REQUIRE(tokens.back().code
+            == http::token::code::error_trailer_block_too_large);
+
+    tokens = read_limited<reader::response>(response_input, policy);
+    REQUIRE(tokens.back().code
+            == http::token::code::error_trailer_block_too_large);
+
+    policy.max_trailer_bytes = 18;
+    tokens = read_limited<reader::response>(response_input, policy);
+    REQUIRE(tokens.back().code == http::token::code::end_of_message);
+}
+
+TEST_CASE("Chunk extension limit", "[limits]")
+{
+    reader::limits policy;
+    policy.max_chunk_ext_size = 10;
+
+    for (std::size_t chunk = 0 ; chunk != 4 ; ++chunk) {
+        std::vector<recorded_token> tokens
+            = read_limited<reader::request>(request_input, policy, chunk);
+        REQUIRE(tokens.back().code
+                == http::token::code::error_chunk_ext_too_long);
+    }
+
+    policy.max_chunk_ext_size = 3;
+    std::vector<recorded_token> tokens
+        = read_limited<reader::response>(response_input, policy);
+    REQUIRE(tokens.back().code == http::token::code::error_chunk_ext_too_long);
+}
+
+TEST_CASE("Limits survive reset()", "[limits]")
+{
+    reader::limits policy;
+    policy.max_target_size = 10;
+
+    reader::request parser;
+    parser.set_limits(&policy);
+    std::string input(request_input);
+    parser.set_buffer(boost::asio::buffer(input.data(), 3));
+    parser.reset();
+    REQUIRE(read_tokens(parser, input).back().code
+            == http::token::code::error_request_target_too_long);
+}
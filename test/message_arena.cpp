@@ -0,0 +1,153 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+
+#include <boost/http/message_arena.hpp>
+#include <boost/http/reader/request.hpp>
+#include <boost/container/pmr/polymorphic_allocator.hpp>
+#include <boost/container/vector.hpp>
+#include <cstring>
+
+namespace http = boost::http;
+namespace pmr = boost::container::pmr;
+
+TEST_CASE("Arena allocations", "[message_arena]")
+{
+    http::arena_block_pool pool(256);
+    http::message_arena arena(pool);
+    pmr::memory_resource &resource = arena;
+
+    char *a = static_cast<char*>(resource.allocate(3, 1));
+    void *b = resource.allocate(8, 8);
+    void *c = resource.allocate(16, 16);
+    REQUIRE(reinterpret_cast<std::size_t>(b) % 8 == 0);
+    REQUIRE(reinterpret_cast<std::size_t>(c) % 16 == 0);
+    REQUIRE(static_cast<char*>(b) >= a + 3);
+    REQUIRE(c >= static_cast<void*>(static_cast<char*>(b) + 8));
+    REQUIRE(arena.used() >= 27);
+
+    // Deallocation is a no-op
+    std::size_t used = arena.used();
+    resource.deallocate(b, 8, 8);
+    REQUIRE(arena.used() == used);
+
+    // Spills into more blocks and large allocations
+    for (int i = 0 ; i != 100 ; ++i)
+        std::memset(resource.allocate(100, 4), 0, 100);
+    std::memset(resource.allocate(1000, 64), 0, 1000);
+
+    REQUIRE(resource.is_equal(arena));
+    http::message_arena other(pool);
+    REQUIRE(!resource.is_equal(other));
+
+    REQUIRE(pool.cached() == 0);
+    arena.release();
+    REQUIRE(arena.used() == 0);
+    // Large allocations aren't pooled
+    REQUIRE(pool.cached() >= 40);
+    REQUIRE(pool.cached() <= 64);
+}
+
+TEST_CASE("Arena blocks are reused", "[message_arena]")
+{
+    http::arena_block_pool pool(1024, 4);
+    void *first;
+
+    {
+        http::message_arena arena(pool);
+        first = arena.allocate(10);
+        for (int i = 0 ; i != 20 ; ++i)
+            arena.allocate(500);
+        arena.release();
+        // Only `max_cached` blocks are kept
+        REQUIRE(pool.cached() == 4);
+
+        REQUIRE(arena.allocate(10) != NULL);
+        REQUIRE(pool.cached() == 3);
+    }
+
+    // The arena gives its blocks back on destruction
+    REQUIRE(pool.cached() == 4);
+
+    http::message_arena arena(pool);
+    for (int i = 0 ; i != 4 ; ++i)
+        arena.allocate(1000);
+    REQUIRE(pool.cached() == 0);
+    arena.release();
+    REQUIRE(pool.cached() == 4);
+    (void)first;
+}
+
+TEST_CASE("Arena as a pmr resource", "[message_arena]")
+{
+    typedef pmr::polymorphic_allocator<int> allocator;
+    typedef boost::container::vector<int, allocator> vector;
+
+    http::arena_block_pool pool;
+    http::message_arena arena(pool);
+    {
+        vector v((allocator(&arena)));
+        for (int i = 0 ; i != 1000 ; ++i)
+            v.push_back(i);
+        REQUIRE(v[999] == 999);
+    }
+    REQUIRE(arena.used() >= 1000 * sizeof(int));
+}
+
+TEST_CASE("One arena per message", "[message_arena]")
+{
+    std::string input("GET / HTTP/1.1\r\n"
+                      "Host: example.com\r\n"
+                      "Accept: text/html\r\n"
+                      "\r\n"
+                      "GET / HTTP/1.1\r\n"
+                      "Host: example.com\r\n"
+                      "Accept: text/html\r\n"
+                      "\r\n");
+
+    http::arena_block_pool pool;
+    http::message_arena arena(pool);
+    http::reader::request parser;
+    parser.set_buffer(boost::asio::buffer(input.data(), input.size()));
+
+    std::vector<boost::string_view> values;
+    const char *first_copy = NULL;
+
+    while (parser.code() != http::token::code::error_insufficient_data) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+
+        switch (parser.code()) {
+        case http::token::code::field_value:
+            {
+                boost::string_view v
+                    = parser.value<http::token::field_value>();
+                char *copy = static_cast<char*>(arena.allocate(v.size(), 1));
+                std::memcpy(copy, v.data(), v.size());
+                values.push_back(boost::string_view(copy, v.size()));
+            }
+            break;
+        case http::token::code::end_of_message:
+            REQUIRE(values.size() == 2);
+            REQUIRE(values[0] == "example.com");
+            REQUIRE(values[1] == "text/html");
+
+            // The next message reuses the same memory
+            if (first_copy)
+                REQUIRE(values[0].data() == first_copy);
+            first_copy = values[0].data();
+
+            values.clear();
+            arena.release();
+            break;
+        default:
+            break;
+        }
+
+        parser.next();
+    }
+
+    REQUIRE(pool.cached() == 1);
+}
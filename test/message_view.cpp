@@ -0,0 +1,209 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+using http::field_name_id;
+
+static const char request_input[] =
+    "POST /upload HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "Content-Type: text/plain \r\n"
+    "X-Custom: first\r\n"
+    "Accept: text/html\r\n"
+    "accept: text/plain\r\n"
+    "Content-Length: 4\r\n"
+    "X-CUSTOM: second\r\n"
+    "\r\n"
+    "Wiki"
+
+    "GET / HTTP/1.1\r\n"
+    "Host: other.com\r\n"
+    "\r\n";
+
+/* Feeds `input` to `parser`, `chunk` bytes at a time, and keeps the bytes of
+   every message around until it ends (as the view requires). `on_headers` is
+   called at every `end_of_headers`. */
+template<class Parser, class F>
+void read_messages(Parser &parser, const std::string &input, std::size_t chunk,
+                   F on_headers)
+{
+    using http::token::code;
+
+    std::string buffer;
+    // Bytes of `buffer` already released to the reader
+    std::size_t parsed = 0;
+    std::size_t fed = 0;
+
+    if (chunk == 0)
+        chunk = input.size();
+
+    while (fed != input.size()) {
+        std::size_t n = std::min(chunk, input.size() - fed);
+        buffer.append(input, fed, n);
+        fed += n;
+
+        parser.set_buffer(boost::asio::buffer(buffer.data() + parsed,
+                                              buffer.size() - parsed));
+
+        while (parser.code() != code::error_insufficient_data) {
+            REQUIRE(parser.symbol() != http::token::symbol::error);
+
+            if (parser.code() == code::end_of_headers)
+                on_headers();
+
+            bool end = parser.code() == code::end_of_message;
+            prepare_token(parser);
+            parser.next();
+
+            if (end) {
+                buffer.erase(0, parsed + parser.parsed_count());
+                parsed = 0;
+                parser.set_buffer(boost::asio::buffer(buffer.data(),
+                                                      buffer.size()));
+            }
+        }
+
+        parsed += parser.parsed_count();
+    }
+}
+
+struct check_request
+{
+    check_request(const reader::message_view &view, int &nmessages)
+        : view(view)
+        , nmessages(nmessages)
+    {}
+
+    void operator()() const
+    {
+        if (nmessages++ == 0) {
+            REQUIRE(view.size() == 7);
+            REQUIRE(view.get(field_name_id::host) == "example.com");
+            REQUIRE(view.get(field_name_id::content_type) == "text/plain");
+            REQUIRE(view.get(field_name_id::content_length) == "4");
+            // The first field of a name gets the slot
+            REQUIRE(view.get(field_name_id::accept) == "text/html");
+            REQUIRE(view.get("ACCEPT") == "text/html");
+            REQUIRE(view.get("x-custom") == "first");
+            REQUIRE(!view.contains(field_name_id::user_agent));
+            REQUIRE(view.get(field_name_id::user_agent).empty());
+            REQUIRE(view.get("x-missing").empty());
+
+            REQUIRE(view.overflow_size() == 3);
+            REQUIRE(view.overflow_id(0) == field_name_id::unknown);
+            REQUIRE(view.overflow_name(0) == "X-Custom");
+            REQUIRE(view.overflow_value(0) == "first");
+            REQUIRE(view.overflow_id(1) == field_name_id::accept);
+            REQUIRE(view.overflow_name(1) == "accept");
+            REQUIRE(view.overflow_value(1) == "text/plain");
+            REQUIRE(view.overflow_name(2) == "X-CUSTOM");
+            REQUIRE(view.overflow_value(2) == "second");
+        } else {
+            REQUIRE(view.size() == 1);
+            REQUIRE(view.get(field_name_id::host) == "other.com");
+            REQUIRE(!view.contains(field_name_id::accept));
+            REQUIRE(view.overflow_size() == 0);
+        }
+    }
+
+    const reader::message_view &view;
+    int &nmessages;
+};
+
+TEST_CASE("Message view", "[message_view]")
+{
+    for (std::size_t chunk = 0 ; chunk != 8 ; ++chunk) {
+        reader::message_view view;
+        reader::request parser;
+        parser.set_message_view(&view);
+        int nmessages = 0;
+        read_messages(parser, request_input, chunk,
+                      check_request(view, nmessages));
+        REQUIRE(nmessages == 2);
+    }
+
+    // Hidden fields and skipped fields aren't recorded
+    reader::field_filter filter;
+    filter.insert(field_name_id::accept);
+    filter.insert(field_name_id::unknown);
+
+    reader::message_view view;
+    reader::request parser;
+    parser.set_message_view(&view);
+    parser.set_field_filter(&filter);
+    parser.set_fast_framing(true);
+    std::string input(request_input);
+    input.erase(input.find("GET"));
+    parser.set_buffer(boost::asio::buffer(input.data(), input.size()));
+    while (parser.code() != http::token::code::end_of_headers)
+        parser.next();
+    REQUIRE(view.size() == 4);
+    REQUIRE(view.get(field_name_id::accept) == "text/html");
+    REQUIRE(view.get("x-custom") == "first");
+    REQUIRE(!view.contains(field_name_id::host));
+    REQUIRE(!view.contains(field_name_id::content_type));
+}
+
+struct check_response
+{
+    check_response(const reader::message_view &view)
+        : view(view)
+    {}
+
+    void operator()() const
+    {
+        REQUIRE(view.size() == 2);
+        REQUIRE(view.get(field_name_id::server) == "test");
+        REQUIRE(view.get(field_name_id::transfer_encoding) == "chunked");
+    }
+
+    const reader::message_view &view;
+};
+
+TEST_CASE("Response message view", "[message_view]")
+{
+    std::string input("HTTP/1.1 200 OK\r\n"
+                      "Server: test\r\n"
+                      "Transfer-Encoding: chunked\r\n"
+                      "\r\n"
+                      "0\r\n"
+                      "Expires: never\r\n"
+                      "\r\n");
+
+    for (std::size_t chunk = 0 ; chunk != 4 ; ++chunk) {
+        reader::message_view view;
+        reader::response parser;
+        parser.set_message_view(&view);
+        read_messages(parser, input, chunk, check_response(view));
+        // Trailers aren't recorded
+        REQUIRE(view.size() == 2);
+    }
+}
+
+TEST_CASE("Message view doesn't allocate", "[message_view]")
+{
+    std::string input("GET / HTTP/1.1\r\nHost: a\r\n");
+    for (int i = 0 ; i != 40 ; ++i)
+        input.append("X-Field: value\r\n");
+    input.append("\r\n");
+
+    reader::message_view view(40);
+    reader::request parser;
+    parser.set_message_view(&view);
+    parser.set_buffer(boost::asio::buffer(input.data(), input.size()));
+    while (parser.code() != http::token::code::end_of_headers)
+        parser.next();
+
+    REQUIRE(view.size() == 41);
+    REQUIRE(view.overflow_size() == 40);
+    // Every value still points into the buffer
+    REQUIRE(view.overflow_value(39).data() == input.data() + input.size()
+            - std::strlen("value\r\n\r\n"));
+}
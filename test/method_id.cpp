@@ -0,0 +1,236 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include <boost/http/method_id.hpp>
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/response.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+typedef http::method_id id;
+
+TEST_CASE("Standard methods are classified", "[method_id]")
+{
+    for (int i = id::unknown + 1 ; i <= id::patch ; ++i) {
+        id::value v = static_cast<id::value>(i);
+        std::string name(id::name(v).data(), id::name(v).size());
+        INFO(name);
+
+        REQUIRE(!name.empty());
+        REQUIRE(id::classify(name) == v);
+        REQUIRE(id::classify(name + 'S') == id::unknown);
+        REQUIRE(id::classify(name.substr(0, name.size() - 1)) == id::unknown);
+    }
+
+    CHECK(id::classify("") == id::unknown);
+    // Methods are case-sensitive
+    CHECK(id::classify("get") == id::unknown);
+    CHECK(id::classify("Head") == id::unknown);
+    CHECK(id::classify("PROPFIND") == id::unknown);
+    CHECK(id::classify(boost::string_view("GET\0", 4)) == id::unknown);
+    CHECK(id::name(id::unknown).empty());
+}
+
+TEST_CASE("Request reader exposes the method id", "[parser,method_id]")
+{
+    const char *inputs[] = {
+        "DELETE /x HTTP/1.1\r\n",
+        "CONNECT a:443 HTTP/1.1\r\n",
+        "BREW /pot HTTP/1.1\r\n"
+    };
+    id::value expected[] = { id::delete_, id::connect, id::unknown };
+
+    for (std::size_t i = 0 ; i != sizeof(inputs) / sizeof(inputs[0]) ; ++i) {
+        reader::request parser;
+        parser.set_buffer(boost::asio::buffer(inputs[i],
+                                              std::strlen(inputs[i])));
+        REQUIRE(parser.code() == http::token::code::method);
+        REQUIRE(parser.value<http::token::method_id>() == expected[i]);
+    }
+}
+
+TEST_CASE("Request line fast path", "[parser,method_id]")
+{
+    using http::token::code;
+
+    for (int i = id::unknown + 1 ; i <= id::patch ; ++i) {
+        id::value v = static_cast<id::value>(i);
+        std::string method(id::name(v).data(), id::name(v).size());
+
+        // Whole line available (fast path) and a byte at a time (slow path)
+        for (int trickle = 0 ; trickle != 2 ; ++trickle) {
+            std::string input = method + " /index.html HTTP/1.1\r\n";
+            INFO(input << (trickle ? " trickled" : ""));
+
+            reader::request parser;
+            std::size_t n = trickle ? 1 : input.size();
+            std::size_t released = 0;
+            parser.set_buffer(boost::asio::buffer(input.data(), n));
+            std::vector<code::value> codes;
+            for (;;) {
+                if (parser.code() == code::error_insufficient_data) {
+                    released += parser.parsed_count();
+                    if (n == input.size())
+                        break;
+                    ++n;
+                    parser.set_buffer(boost::asio::buffer(
+                        input.data() + released, n - released));
+                    continue;
+                }
+                REQUIRE(parser.symbol() != http::token::symbol::error);
+                if (parser.code() == code::method) {
+                    REQUIRE(parser.value<http::token::method>() == method);
+                    REQUIRE(parser.value<http::token::method_id>() == v);
+                }
+                codes.push_back(parser.code());
+                parser.next();
+            }
+
+            const code::value expected[] = {
+                code::method, code::skip, code::request_target, code::skip,
+                code::version, code::skip
+            };
+            REQUIRE(codes == std::vector<code::value>(
+                expected, expected + sizeof(expected) / sizeof(expected[0])));
+            REQUIRE(released == input.size());
+        }
+    }
+
+    // Near misses fall back to the regular (and validating) path
+    const char *inputs[] = {
+        "GETS / HTTP/1.1\r\n",
+        "POSTED / HTTP/1.1\r\n",
+        "get / HTTP/1.1\r\n",
+        "OPTIONSX / HTTP/1.1\r\n",
+        "GET\t/ HTTP/1.1\r\n",
+        "GET / HTTP/2.0\r\n"
+    };
+    const code::value results[] = {
+        code::method, code::method, code::method, code::method,
+        code::error_invalid_data, code::error_invalid_data
+    };
+    for (std::size_t i = 0 ; i != sizeof(inputs) / sizeof(inputs[0]) ; ++i) {
+        INFO(inputs[i]);
+        reader::request parser;
+        parser.set_buffer(boost::asio::buffer(inputs[i],
+                                              std::strlen(inputs[i])));
+        while (parser.code() != code::error_insufficient_data
+               && parser.symbol() != http::token::symbol::error
+               && parser.code() != results[i]) {
+            parser.next();
+        }
+        REQUIRE(parser.code() == results[i]);
+        if (results[i] == code::method)
+            REQUIRE(parser.value<http::token::method_id>() == id::unknown);
+    }
+}
+
+// Token codes and sizes (plus the version) until the end or an error
+static std::vector<std::string> version_line_tokens(const std::string &input,
+                                                    bool trickle)
+{
+    using http::token::code;
+
+    reader::request parser;
+    std::size_t n = trickle ? 1 : input.size();
+    std::size_t released = 0;
+    parser.set_buffer(boost::asio::buffer(input.data(), n));
+    std::vector<std::string> tokens;
+    for (;;) {
+        if (parser.code() == code::error_insufficient_data) {
+            released += parser.parsed_count();
+            if (n == input.size())
+                break;
+            ++n;
+            parser.set_buffer(boost::asio::buffer(input.data() + released,
+                                                  n - released));
+            continue;
+        }
+        std::string t(1, char('a' + parser.code()));
+        t += char('0' + parser.token_size());
+        if (parser.code() == code::version)
+            t += char('0' + parser.value<http::token::version>());
+        tokens.push_back(t);
+        if (parser.symbol() == http::token::symbol::error
+            || parser.code() == code::end_of_message) {
+            break;
+        }
+        parser.next();
+    }
+    return tokens;
+}
+
+TEST_CASE("Version suffix fast path", "[parser,method_id]")
+{
+    // The first two take the fast path, the others fall back to the byte loops
+    const char *lines[] = {
+        "GET / HTTP/1.1\r\n",
+        "GET / HTTP/1.0\r\n",
+        "GET / HTTP/1.1\n",
+        "GET / HTTP/1.5\r\n",
+        "GET / HTTP/1.1\rX",
+        "GET / HTTP/1.1\r\r\n",
+        "GET / HTTP/1.x\r\n"
+    };
+    for (std::size_t i = 0 ; i != sizeof(lines) / sizeof(lines[0]) ; ++i) {
+        std::string input = std::string(lines[i]) + "Host: a\r\n\r\n";
+        INFO(input);
+        std::vector<std::string> tokens = version_line_tokens(input, false);
+        std::vector<std::string> trickled = version_line_tokens(input, true);
+
+        // Trickling splits the OWS skip, so only the request line is compared
+        REQUIRE(tokens.size() > 4);
+        REQUIRE(trickled.size() >= std::min<std::size_t>(tokens.size(), 6));
+        for (std::size_t j = 0 ; j != tokens.size() && j != 6 ; ++j)
+            REQUIRE(tokens[j] == trickled[j]);
+        REQUIRE(tokens.back() == trickled.back());
+        if (i < 2) {
+            REQUIRE(tokens[4][2] == lines[i][13]);
+            REQUIRE(tokens.back()[0] == 'a' + http::token::code::end_of_message);
+        }
+    }
+}
+
+TEST_CASE("response::set_method(method_id)", "[parser,method_id]")
+{
+    const char input[] = "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 4\r\n"
+        "\r\n"
+        "body";
+
+    {
+        reader::response parser;
+        parser.set_buffer(my_buffer(input));
+        while (parser.code() != http::token::code::status_code)
+            parser.next();
+        parser.set_method(id::head);
+
+        while (parser.code() != http::token::code::end_of_headers)
+            parser.next();
+        parser.next();
+        // HEAD responses have no body
+        REQUIRE(parser.code() == http::token::code::end_of_body);
+    }
+
+    {
+        reader::response parser;
+        parser.set_buffer(my_buffer(input));
+        while (parser.code() != http::token::code::status_code)
+            parser.next();
+        parser.set_method(id::get);
+
+        while (parser.code() != http::token::code::end_of_headers)
+            parser.next();
+        parser.next();
+        REQUIRE(parser.code() == http::token::code::body_chunk);
+        REQUIRE(parser.token_size() == 4);
+    }
+}
@@ -0,0 +1,157 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+#include <boost/http/reader/mirrored_buffer.hpp>
+#include <cstring>
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+#ifdef BOOST_HTTP_READER_HAS_MIRRORED_BUFFER
+
+static std::string pipelined_requests()
+{
+    std::string ret;
+    for (int i = 0 ; i != 200 ; ++i) {
+        ret += "POST /upload HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "X-Counter: ";
+        ret += char('a' + i % 26);
+        ret += "\r\n"
+            "Content-Length: 11\r\n"
+            "\r\n"
+            "hello world";
+    }
+    return ret;
+}
+
+TEST_CASE("Mirrored buffer wraps around contiguously", "[mirrored_buffer]")
+{
+    reader::mirrored_buffer buffer(1);
+    const std::size_t capacity = buffer.capacity();
+    REQUIRE(capacity >= 1);
+    REQUIRE(buffer.size() == 0);
+    REQUIRE(asio::buffer_size(buffer.prepare()) == capacity);
+
+    // Move the head close to the end of the first mapping
+    buffer.commit(capacity - 3);
+    buffer.consume(capacity - 3);
+    REQUIRE(buffer.size() == 0);
+
+    asio::mutable_buffer free_space = buffer.prepare();
+    REQUIRE(free_space.size() == capacity);
+    std::memcpy(free_space.data(), "0123456789", 10);
+    buffer.commit(10);
+
+    asio::const_buffer unread = buffer.data();
+    REQUIRE(unread.size() == 10);
+    REQUIRE(std::memcmp(unread.data(), "0123456789", 10) == 0);
+
+    buffer.consume(5);
+    REQUIRE(std::memcmp(buffer.data().data(), "56789", 5) == 0);
+    REQUIRE(asio::buffer_size(buffer.prepare()) == capacity - 5);
+
+    buffer.clear();
+    REQUIRE(buffer.size() == 0);
+}
+
+TEST_CASE("Readers parse straight from a mirrored buffer", "[mirrored_buffer]")
+{
+    const std::string input = pipelined_requests();
+    reader::request expected_parser;
+    std::vector<recorded_token> expected = read_tokens(expected_parser, input,
+                                                     333);
+
+    // Much smaller than the input, so the buffer wraps around many times
+    reader::mirrored_buffer buffer(1);
+    REQUIRE(buffer.capacity() < input.size());
+
+    reader::request parser;
+    std::vector<recorded_token> tokens;
+    std::size_t released = 0;
+    std::size_t fed = 0;
+
+    while (fed != input.size()) {
+        asio::mutable_buffer free_space = buffer.prepare();
+        std::size_t n = std::min<std::size_t>(std::min<std::size_t>(
+            free_space.size(), 333), input.size() - fed);
+        REQUIRE(n != 0);
+        std::memcpy(free_space.data(), input.data() + fed, n);
+        buffer.commit(n);
+        fed += n;
+
+        parser.set_buffer(buffer.data());
+        while (parser.code() != http::token::code::error_insufficient_data) {
+            recorded_token t = {
+                parser.code(),
+                parser.token_size(),
+                released + parser.parsed_count()
+            };
+            tokens.push_back(t);
+            parser.next();
+        }
+
+        released += parser.parsed_count();
+        buffer.consume(parser.parsed_count());
+    }
+
+    REQUIRE(tokens == expected);
+}
+
+TEST_CASE("Mirrored buffer pool reuses mappings", "[mirrored_buffer]")
+{
+    reader::mirrored_buffer_pool pool(3);
+    reader::mirrored_buffer a;
+    reader::mirrored_buffer b;
+    reader::mirrored_buffer c;
+    REQUIRE(a.capacity() == 0);
+
+    pool.acquire(a, 1);
+    pool.acquire(b, 1);
+    pool.acquire(c, 1);
+    REQUIRE(a.capacity() != 0);
+    REQUIRE(pool.cached() == 0);
+
+    a.commit(1);
+    const void *storage = a.prepare().data();
+
+    pool.release(a);
+    REQUIRE(a.capacity() == 0);
+    REQUIRE(a.size() == 0);
+    REQUIRE(pool.cached() == 1);
+
+    // Storage comes back empty
+    pool.acquire(a, 1);
+    REQUIRE(pool.cached() == 0);
+    REQUIRE(a.size() == 0);
+    REQUIRE(static_cast<const char*>(a.prepare().data()) + 1
+            == static_cast<const char*>(storage));
+
+    // Best fit
+    pool.release(a);
+    pool.acquire(b, 3 * b.capacity());
+    REQUIRE(pool.cached() == 2);
+    std::size_t large = b.capacity();
+    pool.release(b);
+    REQUIRE(pool.cached() == 3);
+    pool.acquire(a, 1);
+    REQUIRE(a.capacity() < large);
+    pool.acquire(b, large);
+    REQUIRE(b.capacity() == large);
+    REQUIRE(pool.cached() == 1);
+
+    // Swap exchanges the storage
+    a.swap(b);
+    REQUIRE(a.capacity() == large);
+    pool.release(a);
+    pool.release(b);
+    pool.release(c);
+    REQUIRE(pool.cached() == 3);
+}
+
+#endif // BOOST_HTTP_READER_HAS_MIRRORED_BUFFER
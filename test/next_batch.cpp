@@ -0,0 +1,421 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const char request_input[] =
+    "GET / HTTP/1.1\r\n"
+    "host: aliceinthewonderland.com\t \r\n"
+    "\r\n"
+
+    "POST /upload HTTP/1.1\r\n"
+    "Content-length: 4\r\n"
+    "host:thelastringbearer.org\r\n"
+    "\r\n"
+    "ping"
+
+    "POST http://notheaven.onion/ HTTP/1.1\r\n"
+    "Host: playwithme.onion\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "4;ext=\"quoted\"\r\n"
+    "Wiki\r\n"
+    "0\r\n"
+    "Content-MD5: 25b83662323c397c9944a8a7b3fef7ab  \r\n"
+    "\r\n";
+
+static const char response_input[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 5\r\n"
+    "X-Pants: On \r\n"
+    "\r\n"
+    "hello"
+
+    "HTTP/1.1 200 A longer reason phrase\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "3\r\n"
+    "abc\r\n"
+    "0\r\n"
+    "\r\n";
+
+static std::size_t value_size(reader::request &parser)
+{
+    using http::token::code;
+
+    switch (parser.code()) {
+    case code::field_value:
+        return parser.value<http::token::field_value>().size();
+    case code::trailer_value:
+        return parser.value<http::token::trailer_value>().size();
+    default:
+        return parser.token_size();
+    }
+}
+
+static std::size_t value_size(reader::response &parser)
+{
+    using http::token::code;
+
+    switch (parser.code()) {
+    case code::field_value:
+        return parser.value<http::token::field_value>().size();
+    case code::trailer_value:
+        return parser.value<http::token::trailer_value>().size();
+    default:
+        return parser.token_size();
+    }
+}
+
+static int value_id(reader::request &parser)
+{
+    using http::token::code;
+
+    switch (parser.code()) {
+    case code::method:
+        return parser.value<http::token::method_id>();
+    case code::field_name:
+    case code::trailer_name:
+        return parser.value<http::token::field_name_id>();
+    default:
+        return 0;
+    }
+}
+
+static int value_id(reader::response &parser)
+{
+    using http::token::code;
+
+    switch (parser.code()) {
+    case code::field_name:
+    case code::trailer_name:
+        return parser.value<http::token::field_name_id>();
+    default:
+        return 0;
+    }
+}
+
+// A token plus the extra fields of `reader::token_record`
+struct batched_token
+{
+    bool operator==(const batched_token &o) const
+    {
+        return token == o.token && id == o.id && final_piece == o.final_piece;
+    }
+
+    recorded_token token;
+    int id;
+    bool final_piece;
+};
+
+inline std::ostream &operator<<(std::ostream &os, const batched_token &t)
+{
+    return os << t.token << (t.final_piece ? "" : "+") << '#' << t.id;
+}
+
+// Non-skip tokens as seen through the one-token-at-a-time interface
+template<class Parser>
+std::vector<batched_token> pull_tokens(const std::string &input,
+                                       std::size_t chunk, bool split)
+{
+    Parser parser;
+    parser.set_token_splitting(split);
+    std::vector<batched_token> ret;
+    std::string buffer;
+    std::size_t released = 0;
+
+    for (std::size_t fed = 0 ; fed != input.size() ; ) {
+        std::size_t n = std::min(chunk, input.size() - fed);
+        buffer.append(input, fed, n);
+        fed += n;
+        parser.set_buffer(asio::buffer(buffer.data(), buffer.size()));
+
+        while (parser.code() != http::token::code::error_insufficient_data) {
+            REQUIRE(parser.symbol() != http::token::symbol::error);
+            if (parser.code() != http::token::code::skip) {
+                batched_token t = {
+                    {
+                        parser.code(),
+                        value_size(parser),
+                        released + parser.parsed_count()
+                    },
+                    value_id(parser),
+                    parser.final_piece()
+                };
+                ret.push_back(t);
+            }
+            prepare_token(parser);
+            parser.next();
+        }
+
+        released += parser.parsed_count();
+        buffer.erase(0, parser.parsed_count());
+    }
+
+    return ret;
+}
+
+template<class Parser>
+std::vector<batched_token> batch_tokens(const std::string &input,
+                                        std::size_t chunk, std::size_t batch,
+                                        bool split)
+{
+    Parser parser;
+    parser.set_token_splitting(split);
+    std::vector<batched_token> ret;
+    std::vector<reader::token_record> tape(batch);
+    std::string buffer;
+    std::size_t released = 0;
+
+    for (std::size_t fed = 0 ; fed != input.size() ; ) {
+        std::size_t n = std::min(chunk, input.size() - fed);
+        buffer.append(input, fed, n);
+        fed += n;
+        parser.set_buffer(asio::buffer(buffer.data(), buffer.size()));
+
+        for (;;) {
+            std::size_t count = parser.next_batch(&tape[0], batch);
+            REQUIRE(count <= batch);
+            for (std::size_t i = 0 ; i != count ; ++i) {
+                REQUIRE(tape[i].code != http::token::code::skip);
+                REQUIRE(tape[i].offset + tape[i].size <= buffer.size());
+                batched_token t = {
+                    {
+                        tape[i].code,
+                        tape[i].size,
+                        released + tape[i].offset
+                    },
+                    tape[i].id,
+                    tape[i].final_piece
+                };
+                ret.push_back(t);
+            }
+
+            if (count == batch)
+                continue;
+
+            if (parser.code() == http::token::code::error_insufficient_data)
+                break;
+
+            REQUIRE(parser.symbol() != http::token::symbol::error);
+            // The only other reason to stop
+            REQUIRE(parser.code() == http::token::code::status_code);
+            prepare_token(parser);
+        }
+
+        released += parser.parsed_count();
+        buffer.erase(0, parser.parsed_count());
+    }
+
+    return ret;
+}
+
+template<class Parser>
+void check_batches(const std::string &input)
+{
+    const std::size_t chunks[] = { 1, 7, 64, 1000 };
+    const std::size_t batches[] = { 1, 2, 5, 64 };
+
+    for (int split = 0 ; split != 2 ; ++split) {
+        for (std::size_t i = 0 ; i != sizeof(chunks) / sizeof(chunks[0])
+                 ; ++i) {
+            std::vector<batched_token> expected
+                = pull_tokens<Parser>(input, chunks[i], split);
+            REQUIRE(!expected.empty());
+
+            for (std::size_t j = 0 ; j != sizeof(batches) / sizeof(batches[0])
+                     ; ++j) {
+                INFO("chunk " << chunks[i] << ", batch " << batches[j]
+                     << (split ? ", split" : ""));
+                REQUIRE(batch_tokens<Parser>(input, chunks[i], batches[j],
+                                             split)
+                        == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Batched tokens match pulled tokens", "[parser]")
+{
+    check_batches<reader::request>(request_input);
+    check_batches<reader::response>(response_input);
+}
+
+/* `input` given at once as two segments split at `split`. Batches of `batch`
+   tokens (0 pulls them one at a time). */
+template<class Parser>
+std::vector<batched_token> sequence_tokens(const std::string &input,
+                                           std::size_t split,
+                                           std::size_t batch,
+                                           const reader::limits *limits)
+{
+    std::vector<asio::const_buffer> buffers;
+    buffers.push_back(asio::buffer(input.data(), split));
+    buffers.push_back(asio::buffer(input.data() + split,
+                                   input.size() - split));
+
+    Parser parser;
+    parser.set_limits(limits);
+    parser.set_buffer(buffers);
+    std::vector<batched_token> ret;
+    std::vector<reader::token_record> tape(batch ? batch : 1);
+
+    while (parser.code() != http::token::code::error_insufficient_data) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+
+        if (batch == 0 || parser.code() == http::token::code::status_code) {
+            if (parser.code() != http::token::code::skip) {
+                batched_token t = {
+                    {
+                        parser.code(),
+                        value_size(parser),
+                        parser.parsed_count()
+                    },
+                    value_id(parser),
+                    parser.final_piece()
+                };
+                ret.push_back(t);
+            }
+            prepare_token(parser);
+            parser.next();
+            continue;
+        }
+
+        std::size_t count = parser.next_batch(&tape[0], batch);
+        for (std::size_t i = 0 ; i != count ; ++i) {
+            batched_token t = {
+                { tape[i].code, tape[i].size, tape[i].offset },
+                tape[i].id,
+                tape[i].final_piece
+            };
+            ret.push_back(t);
+        }
+    }
+
+    REQUIRE(parser.parsed_count() == input.size());
+    return ret;
+}
+
+template<class Parser>
+void check_sequences(const std::string &input)
+{
+    // Limits make every token go through `next()`
+    reader::limits limits;
+
+    for (std::size_t split = 1 ; split != input.size() ; ++split) {
+        std::vector<batched_token> expected
+            = sequence_tokens<Parser>(input, split, 0, NULL);
+
+        for (std::size_t batch = 1 ; batch < 9 ; batch += 7) {
+            INFO("split " << split << ", batch " << batch);
+            REQUIRE(sequence_tokens<Parser>(input, split, batch, NULL)
+                    == expected);
+            REQUIRE(sequence_tokens<Parser>(input, split, batch, &limits)
+                    == expected);
+        }
+    }
+}
+
+TEST_CASE("Batched tokens over buffer sequences", "[parser]")
+{
+    check_sequences<reader::request>(request_input);
+    check_sequences<reader::response>(response_input);
+}
+
+TEST_CASE("Batch records ids and pieces", "[parser]")
+{
+    const char input[] = "POST / HTTP/1.1\r\n"
+        "Host: a\r\n"
+        "X-Unknown: 0123456789\r\n"
+        "\r\n";
+    reader::request parser;
+    reader::token_record tape[16];
+
+    parser.set_token_splitting(true);
+    // Stops in the middle of the value of `X-Unknown`
+    parser.set_buffer(asio::buffer(input, 40));
+    REQUIRE(parser.next_batch(tape, 16) == 7);
+    REQUIRE(tape[0].code == http::token::code::method);
+    REQUIRE(tape[0].id == http::method_id::post);
+    REQUIRE(tape[3].code == http::token::code::field_name);
+    REQUIRE(tape[3].id == http::field_name_id::host);
+    REQUIRE(tape[4].final_piece);
+    REQUIRE(tape[5].code == http::token::code::field_name);
+    REQUIRE(tape[5].id == http::field_name_id::unknown);
+    REQUIRE(tape[6].code == http::token::code::field_value);
+    REQUIRE(tape[6].id == 0);
+    REQUIRE(!tape[6].final_piece);
+    REQUIRE(tape[6].size == 3);
+    REQUIRE(parser.code() == http::token::code::error_insufficient_data);
+}
+
+TEST_CASE("Batch offsets are positions within the sequence", "[parser]")
+{
+    const std::string input = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+    std::vector<asio::const_buffer> buffers;
+    buffers.push_back(asio::buffer(input.data(), 20));
+    buffers.push_back(asio::buffer(input.data() + 20, input.size() - 20));
+
+    reader::request parser;
+    reader::token_record tape[16];
+    parser.set_buffer(buffers);
+    std::size_t count = parser.next_batch(tape, 16);
+    REQUIRE(count == 8);
+    for (std::size_t i = 0 ; i != count ; ++i) {
+        if (tape[i].code == http::token::code::field_value) {
+            REQUIRE(input.substr(tape[i].offset, tape[i].size) == "a");
+            REQUIRE(tape[i].offset == 22);
+        }
+    }
+}
+
+TEST_CASE("Batch stops before errors", "[parser]")
+{
+    const char input[] = "GET / HTTP/1.1\r\nX-Bad Name: value\r\n\r\n";
+    reader::request parser;
+    reader::token_record tape[16];
+
+    parser.set_buffer(asio::buffer(input, sizeof(input) - 1));
+    std::size_t count = parser.next_batch(tape, 16);
+    REQUIRE(count == 4);
+    REQUIRE(tape[0].code == http::token::code::method);
+    REQUIRE(tape[0].offset == 0);
+    REQUIRE(tape[0].size == 3);
+    REQUIRE(tape[3].code == http::token::code::field_name);
+    REQUIRE(tape[3].offset == 16);
+    REQUIRE(tape[3].size == 5);
+    REQUIRE(parser.code() == http::token::code::error_invalid_data);
+
+    // Errors are sticky
+    REQUIRE(parser.next_batch(tape, 16) == 0);
+}
+
+TEST_CASE("Batch stops at status code until the method is set", "[parser]")
+{
+    const char input[] = "HTTP/1.1 204 No Content\r\n\r\n";
+    reader::response parser;
+    reader::token_record tape[16];
+
+    parser.set_buffer(asio::buffer(input, sizeof(input) - 1));
+    REQUIRE(parser.next_batch(tape, 16) == 1);
+    REQUIRE(tape[0].code == http::token::code::version);
+    REQUIRE(parser.code() == http::token::code::status_code);
+    REQUIRE(parser.next_batch(tape, 16) == 0);
+
+    parser.set_method(http::method_id::get);
+    REQUIRE(parser.next_batch(tape, 16) == 5);
+    REQUIRE(tape[0].code == http::token::code::status_code);
+    REQUIRE(tape[0].offset == 9);
+    REQUIRE(tape[1].code == http::token::code::reason_phrase);
+    REQUIRE(tape[2].code == http::token::code::end_of_headers);
+    REQUIRE(tape[3].code == http::token::code::end_of_body);
+    REQUIRE(tape[4].code == http::token::code::end_of_message);
+    REQUIRE(parser.code() == http::token::code::error_insufficient_data);
+}
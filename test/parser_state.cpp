@@ -0,0 +1,251 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+#include <boost/http/reader/parser_state.hpp>
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+using http::token::code;
+
+static const char request_input[] =
+    "POST /upload?q=1 HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "Connection: keep-alive, upgrade\r\n"
+    "Upgrade: websocket\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "X-Custom: some value \r\n"
+    "\r\n"
+    "4;ext=1\r\n"
+    "Wiki\r\n"
+    "5\r\n"
+    "pedia\r\n"
+    "0\r\n"
+    "X-Trailer: value\r\n"
+    "\r\n"
+
+    "GET / HTTP/1.0\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Length: 4\r\n"
+    "\r\n"
+    "Wiki";
+
+static const char response_input[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 4\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "Wiki"
+
+    "HTTP/1.1 200 OK\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "3\r\n"
+    "abc\r\n"
+    "0\r\n"
+    "\r\n";
+
+// A connection served by a reader shared with other connections
+struct connection
+{
+    explicit connection(const std::string &input)
+        : input(input)
+        , fed(0)
+        , released(0)
+    {}
+
+    bool done() const
+    {
+        return fed == input.size();
+    }
+
+    std::string input;
+    std::size_t fed;
+
+    std::string buffer;
+    std::size_t released;
+
+    reader::parser_state state;
+    std::vector<recorded_token> tokens;
+};
+
+// Delivers the next `chunk` bytes of `c` through `parser`
+template<class Parser>
+void receive(Parser &parser, connection &c, std::size_t chunk)
+{
+    std::size_t n = std::min(chunk, c.input.size() - c.fed);
+    c.buffer.append(c.input, c.fed, n);
+    c.fed += n;
+
+    parser.load(c.state);
+    parser.set_buffer(boost::asio::buffer(c.buffer.data(), c.buffer.size()));
+
+    while (parser.code() != code::error_insufficient_data) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+
+        recorded_token t = {
+            parser.code(),
+            parser.token_size(),
+            c.released + parser.parsed_count()
+        };
+        c.tokens.push_back(t);
+
+        prepare_token(parser);
+        parser.next();
+    }
+
+    c.released += parser.parsed_count();
+    c.buffer.erase(0, parser.parsed_count());
+    parser.save(c.state);
+}
+
+/* Serves three connections (each with its own input) with `parser`, `chunk`
+   bytes at a time in turns, and checks each of them gets the tokens of a
+   reader of its own. */
+template<class Parser>
+void check_shared(Parser &parser, Parser &dedicated, const std::string &input,
+                  std::size_t chunk)
+{
+    std::vector<connection> connections;
+    connections.push_back(connection(input));
+    connections.push_back(connection(input + input));
+    connections.push_back(connection(input + input + input));
+
+    for (bool done = false ; !done ;) {
+        done = true;
+        for (std::size_t i = 0 ; i != connections.size() ; ++i) {
+            if (connections[i].done())
+                continue;
+
+            done = false;
+            receive(parser, connections[i], chunk);
+        }
+    }
+
+    for (std::size_t i = 0 ; i != connections.size() ; ++i) {
+        dedicated.reset();
+        std::vector<recorded_token> expected
+            = read_tokens(dedicated, connections[i].input, chunk);
+        REQUIRE(expected.back().code == code::end_of_message);
+        REQUIRE(connections[i].tokens == expected);
+    }
+}
+
+TEST_CASE("parser_state size", "[parser_state]")
+{
+    REQUIRE(sizeof(reader::parser_state) <= 24);
+}
+
+TEST_CASE("Requests served by a shared reader", "[parser_state]")
+{
+    for (std::size_t chunk = 1 ; chunk != 12 ; ++chunk) {
+        reader::request parser;
+        reader::request dedicated;
+        check_shared(parser, dedicated, request_input, chunk);
+    }
+}
+
+TEST_CASE("Responses served by a shared reader", "[parser_state]")
+{
+    for (std::size_t chunk = 1 ; chunk != 12 ; ++chunk) {
+        reader::response parser;
+        reader::response dedicated;
+        check_shared(parser, dedicated, response_input, chunk);
+    }
+}
+
+TEST_CASE("Shared reader settings", "[parser_state]")
+{
+    reader::limits policy;
+    policy.max_fields = 5;
+    policy.max_header_bytes = 160;
+
+    for (std::size_t chunk = 1 ; chunk != 12 ; ++chunk) {
+        reader::request parser;
+        reader::request dedicated;
+        parser.set_limits(&policy);
+        parser.set_token_splitting(true);
+        dedicated.set_limits(&policy);
+        dedicated.set_token_splitting(true);
+        check_shared(parser, dedicated, request_input, chunk);
+    }
+
+    // The counters of the saved message are enforced after `load()`
+    policy.max_fields = 4;
+    reader::request parser;
+    parser.set_limits(&policy);
+
+    std::string input(request_input);
+    reader::parser_state state;
+    std::string buffer;
+    for (std::size_t i = 0 ; i != input.size() ; ++i) {
+        buffer += input[i];
+        parser.load(state);
+        parser.set_buffer(boost::asio::buffer(buffer.data(), buffer.size()));
+        while (parser.code() != code::error_insufficient_data
+               && parser.symbol() != http::token::symbol::error) {
+            parser.next();
+        }
+        if (parser.code() != code::error_insufficient_data)
+            break;
+        buffer.erase(0, parser.parsed_count());
+        parser.save(state);
+    }
+    REQUIRE(parser.code() == code::error_too_many_fields);
+}
+
+/* Parses `head` (which ends in the middle of a field name), saves the state
+   and resumes with the bytes left unparsed. The bytes scanned before `save()`
+   are overwritten with bytes that can't be part of a field name, so the token
+   is only found if `load()` resumed the scan where it stopped. */
+template<class Parser>
+void check_resumed_scan(const std::string &head)
+{
+    Parser parser;
+    parser.set_buffer(boost::asio::buffer(head.data(), head.size()));
+    while (parser.code() != code::error_insufficient_data) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+        prepare_token(parser);
+        parser.next();
+    }
+
+    reader::parser_state state;
+    parser.save(state);
+
+    std::string rest = head.substr(parser.parsed_count());
+    REQUIRE(rest == "X-Long");
+    rest.replace(0, rest.size(), rest.size(), ' ');
+    rest += "-Name: v\r\n\r\n";
+
+    Parser other;
+    other.load(state);
+    other.set_buffer(boost::asio::buffer(rest.data(), rest.size()));
+    REQUIRE(other.code() == code::field_name);
+    REQUIRE(other.token_size() == 11);
+}
+
+TEST_CASE("Partial tokens aren't scanned again", "[parser_state]")
+{
+    check_resumed_scan<reader::request>("GET / HTTP/1.0\r\nX-Long");
+    check_resumed_scan<reader::response>("HTTP/1.0 200 OK\r\nX-Long");
+}
+
+TEST_CASE("Default state starts a new message", "[parser_state]")
+{
+    reader::request parser;
+    parser.set_buffer(boost::asio::buffer("GET / HTTP/1.1\r\nHo", 18));
+    REQUIRE(parser.code() == code::method);
+
+    parser.load(reader::parser_state());
+    REQUIRE(parser.code() == code::error_insufficient_data);
+    REQUIRE(parser.parsed_count() == 0);
+
+    parser.set_buffer(boost::asio::buffer("PUT / HTTP/1.1\r\n", 16));
+    REQUIRE(parser.code() == code::method);
+    REQUIRE(parser.value<http::token::method>() == "PUT");
+}
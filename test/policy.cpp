@@ -0,0 +1,193 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+#include <boost/type_traits/is_same.hpp>
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const char chunked_request[] =
+    "POST / HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "4\r\n"
+    "Wiki\r\n"
+    "0\r\n"
+    "\r\n";
+
+static const char chunked_response[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "4\r\n"
+    "Wiki\r\n"
+    "0\r\n"
+    "\r\n";
+
+struct no_http_1_0: reader::default_policy
+{
+    static const bool http_1_0 = false;
+};
+
+struct raw_values: reader::default_policy
+{
+    static const bool trim_ows = false;
+};
+
+struct no_limits: reader::default_policy
+{
+    static const bool enforce_limits = false;
+};
+
+struct counting: reader::default_policy
+{
+    static void on_token(http::token::code::value code, std::size_t size)
+    {
+        if (code == http::token::code::skip)
+            ++skips;
+        else
+            ++tokens;
+        bytes += size;
+    }
+
+    static std::size_t tokens;
+    static std::size_t skips;
+    static std::size_t bytes;
+};
+
+std::size_t counting::tokens = 0;
+std::size_t counting::skips = 0;
+std::size_t counting::bytes = 0;
+
+template<class Parser>
+http::token::code::value last_code(const std::string &input)
+{
+    Parser parser;
+    return read_tokens(parser, input).back().code;
+}
+
+TEST_CASE("Default policy", "[policy]")
+{
+    REQUIRE((boost::is_same<reader::request,
+                            reader::basic_request<reader::default_policy> >
+             ::value));
+    REQUIRE((boost::is_same<reader::response,
+                            reader::basic_response<reader::default_policy> >
+             ::value));
+}
+
+TEST_CASE("Strict policy", "[policy]")
+{
+    typedef reader::basic_request<reader::strict_policy> strict_request;
+    typedef reader::basic_response<reader::strict_policy> strict_response;
+
+    using http::token::code;
+
+    // Well-formed messages are read the same way
+    {
+        reader::request parser;
+        strict_request strict;
+        REQUIRE(read_tokens(strict, chunked_request)
+                == read_tokens(parser, chunked_request));
+    }
+    {
+        reader::response parser;
+        strict_response strict;
+        REQUIRE(read_tokens(strict, chunked_response)
+                == read_tokens(parser, chunked_response));
+    }
+
+    std::string bare_lf("GET / HTTP/1.1\r\nHost: a\n\r\n");
+    REQUIRE(last_code<reader::request>(bare_lf) == code::end_of_message);
+    REQUIRE(last_code<strict_request>(bare_lf) == code::error_invalid_data);
+    REQUIRE(last_code<strict_request>("GET / HTTP/1.1\nHost: a\r\n\r\n")
+            == code::error_invalid_data);
+    REQUIRE(last_code<strict_request>("GET / HTTP/1.1\r\nHost: a\r\n\n")
+            == code::error_invalid_data);
+    REQUIRE(last_code<strict_response>("HTTP/1.1 200 OK\n\r\n")
+            == code::error_invalid_data);
+
+    std::string ext(chunked_request);
+    ext.replace(ext.find("4\r\n"), 3, "4;a=b\r\n");
+    REQUIRE(last_code<reader::request>(ext) == code::end_of_message);
+    REQUIRE(last_code<strict_request>(ext) == code::error_invalid_data);
+
+    std::string trailer(chunked_request);
+    trailer.insert(trailer.size() - 2, "Expires: never\r\n");
+    REQUIRE(last_code<reader::request>(trailer) == code::end_of_message);
+    REQUIRE(last_code<strict_request>(trailer) == code::error_invalid_data);
+
+    std::string response_trailer(chunked_response);
+    response_trailer.insert(response_trailer.size() - 2, "Expires: never\r\n");
+    REQUIRE(last_code<reader::response>(response_trailer)
+            == code::end_of_message);
+    REQUIRE(last_code<strict_response>(response_trailer)
+            == code::error_invalid_data);
+}
+
+TEST_CASE("HTTP/1.0 can be rejected", "[policy]")
+{
+    using http::token::code;
+
+    std::string input("GET / HTTP/1.0\r\n\r\n");
+    REQUIRE(last_code<reader::request>(input) == code::end_of_message);
+    REQUIRE(last_code<reader::basic_request<no_http_1_0> >(input)
+            == code::error_invalid_data);
+    REQUIRE(last_code<reader::basic_response<no_http_1_0> >("HTTP/1.0 200 OK"
+                                                            "\r\n\r\n")
+            == code::error_invalid_data);
+}
+
+TEST_CASE("Untrimmed field values", "[policy]")
+{
+    std::string input("GET / HTTP/1.1\r\nHost: a \t \r\n"
+                      "Content-Length: 0 \r\n\r\n");
+
+    reader::basic_request<raw_values> parser;
+    parser.set_buffer(boost::asio::buffer(input.data(), input.size()));
+    std::vector<std::string> values;
+    while (parser.code() != http::token::code::end_of_message) {
+        REQUIRE(parser.symbol() != http::token::symbol::error);
+        if (parser.code() == http::token::code::field_value) {
+            http::reader::request::view_type v
+                = parser.value<http::token::field_value>();
+            values.push_back(std::string(v.data(), v.size()));
+        }
+        parser.next();
+    }
+
+    REQUIRE(values.size() == 2);
+    REQUIRE(values[0] == "a \t ");
+    // The framing still uses the trimmed value
+    REQUIRE(values[1] == "0 ");
+}
+
+TEST_CASE("Limits compile away", "[policy]")
+{
+    reader::limits policy;
+    policy.max_fields = 0;
+
+    std::string input("GET / HTTP/1.1\r\nHost: a\r\n\r\n");
+    reader::basic_request<no_limits> parser;
+    parser.set_limits(&policy);
+    REQUIRE(read_tokens(parser, input).back().code
+            == http::token::code::end_of_message);
+}
+
+TEST_CASE("Instrumentation hook", "[policy]")
+{
+    // Every token is seen, even the ones folded within `next()`
+    reader::basic_request<counting> parser;
+    parser.set_skip_folding(true);
+    std::vector<recorded_token> tokens = read_tokens(parser, chunked_request);
+
+    REQUIRE(counting::tokens == tokens.size());
+    REQUIRE(counting::skips != 0);
+    REQUIRE(counting::bytes == sizeof(chunked_request) - 1);
+}
@@ -526,6 +526,11 @@ void my_tester(const char (&input)[N],
             case http::token::code::error_content_length_overflow:
             case http::token::code::error_invalid_transfer_encoding:
             case http::token::code::error_chunk_size_overflow:
+            case http::token::code::error_request_target_too_long:
+            case http::token::code::error_too_many_fields:
+            case http::token::code::error_header_block_too_large:
+            case http::token::code::error_trailer_block_too_large:
+            case http::token::code::error_chunk_ext_too_long:
                 output.push_back(make_error(parser.code()));
                 stop = true;
                 break;
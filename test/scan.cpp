@@ -0,0 +1,102 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include <boost/http/detail/scan.hpp>
+#include <boost/http/reader/detail/common.hpp>
+#include <boost/http/syntax/field_name.hpp>
+#include <boost/http/syntax/field_value.hpp>
+#include <vector>
+
+namespace http = boost::http;
+namespace detail = http::detail;
+
+typedef bool (*predicate)(unsigned char);
+
+static bool is_field_value_char(unsigned char c)
+{
+    return http::reader::detail::is_ows(c) || http::reader::detail::is_vchar(c)
+        || http::reader::detail::is_obs_text(c);
+}
+
+static std::size_t reference_scan(predicate pred, const unsigned char *p,
+                                  std::size_t n)
+{
+    for (std::size_t i = 0 ; i != n ; ++i) {
+        if (!pred(p[i]))
+            return i;
+    }
+    return n;
+}
+
+static void check_class(detail::scan_class cls, predicate pred)
+{
+    detail::scan_level best = detail::detect_scan_level();
+
+    // a valid byte to fill the buffer with
+    unsigned char fill = 0;
+    while (!pred(fill))
+        ++fill;
+
+    for (int l = detail::SCAN_SCALAR ; l <= best ; ++l) {
+        detail::scan_level level = static_cast<detail::scan_level>(l);
+
+        for (std::size_t size = 0 ; size != 150 ; ++size) {
+            // the offset exercises unaligned loads
+            std::vector<unsigned char> buf(size + 3, fill);
+            const unsigned char *p = &buf[3];
+
+            REQUIRE(detail::scan(level, cls, p, size) == size);
+
+            for (std::size_t pos = 0 ; pos < size ; pos += 7) {
+                for (int c = 0 ; c != 256 ; ++c) {
+                    buf[3 + pos] = static_cast<unsigned char>(c);
+                    std::size_t expected = reference_scan(pred, p, size);
+                    // Catch assertions are too slow for this many iterations
+                    if (detail::scan(level, cls, p, size) != expected
+                        || detail::scan(cls, p, size) != expected) {
+                        INFO("level " << l << ", size " << size << ", byte "
+                             << c << " at " << pos);
+                        REQUIRE(detail::scan(level, cls, p, size) == expected);
+                        REQUIRE(detail::scan(cls, p, size) == expected);
+                    }
+                }
+                buf[3 + pos] = fill;
+            }
+        }
+    }
+}
+
+TEST_CASE("scan tchar", "[detail]")
+{
+    check_class(detail::SCAN_TCHAR, http::reader::detail::is_tchar);
+}
+
+TEST_CASE("scan request-target", "[detail]")
+{
+    check_class(detail::SCAN_REQUEST_TARGET,
+                http::reader::detail::is_request_target_char);
+}
+
+TEST_CASE("scan field-value", "[detail]")
+{
+    check_class(detail::SCAN_FIELD_VALUE, is_field_value_char);
+    check_class(detail::SCAN_FIELD_VALUE,
+                http::reader::detail::is_chunk_ext_char);
+}
+
+TEST_CASE("syntax matchers use the scanners", "[syntax]")
+{
+    typedef http::syntax::field_name<unsigned char> field_name;
+    typedef http::syntax::left_trimmed_field_value<unsigned char> field_value;
+
+    const unsigned char name[] = "X-Some-Quite-Long-Header-Name-Here: v";
+    CHECK(field_name::match(field_name::view_type(name, sizeof(name) - 1))
+          == 34);
+
+    const unsigned char value[] = "text/html, application/xhtml+xml,\xE9\t*\r";
+    CHECK(field_value::match(field_value::view_type(value, sizeof(value) - 1))
+          == sizeof(value) - 2);
+}
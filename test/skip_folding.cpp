@@ -0,0 +1,118 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const char *requests[] = {
+    "GET / HTTP/1.1\r\n"
+    "host: aliceinthewonderland.com\t \r\n"
+    "\r\n"
+
+    "POST /upload HTTP/1.1\r\n"
+    "Content-length: 4\r\n"
+    "host:    \t  thelastringbearer.org\r\n"
+    "\r\n"
+    "ping"
+
+    "POST http://notheaven.onion/ HTTP/1.1\r\n"
+    "Host: playwithme.onion\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "4;ext=\"quoted\"\r\n"
+    "Wiki\r\n"
+    "0\r\n"
+    "Content-MD5: 25b83662323c397c9944a8a7b3fef7ab\r\n"
+    "\r\n",
+
+    "GET / HTTP/1.1\r\n"
+    "X-Bad Name: value\r\n"
+    "\r\n"
+};
+
+static const char *responses[] = {
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 5\r\n"
+    "X-Pants: On\r\n"
+    "\r\n"
+    "hello"
+
+    "HTTP/1.1 200 A longer reason phrase\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "3\r\n"
+    "abc\r\n"
+    "0\r\n"
+    "Trailer-Name: trailer value\r\n"
+    "\r\n"
+};
+
+static std::vector<recorded_token> without_skip(std::vector<recorded_token> v)
+{
+    std::vector<recorded_token> ret;
+    for (std::size_t i = 0 ; i != v.size() ; ++i) {
+        if (v[i].code != http::token::code::skip)
+            ret.push_back(v[i]);
+    }
+    return ret;
+}
+
+template<class Parser>
+void check_folding(const std::string &input)
+{
+    const std::size_t chunks[] = { 0, 1, 2, 3, 7, 64 };
+
+    for (std::size_t i = 0 ; i != sizeof(chunks) / sizeof(chunks[0]) ; ++i) {
+        Parser plain;
+        Parser folding;
+        folding.set_skip_folding(true);
+
+        INFO("chunk size " << chunks[i]);
+        std::vector<recorded_token> expected
+            = without_skip(read_tokens(plain, input, chunks[i]));
+        std::vector<recorded_token> tokens
+            = read_tokens(folding, input, chunks[i]);
+        REQUIRE(tokens == expected);
+        REQUIRE(folding.parsed_count() == plain.parsed_count());
+
+        // The setting survives `reset()`
+        plain.reset();
+        folding.reset();
+        REQUIRE(read_tokens(folding, input)
+                == without_skip(read_tokens(plain, input)));
+    }
+}
+
+TEST_CASE("Folded request skips", "[parser]")
+{
+    for (std::size_t i = 0 ; i != sizeof(requests) / sizeof(requests[0])
+             ; ++i) {
+        check_folding<reader::request>(requests[i]);
+    }
+}
+
+TEST_CASE("Folded response skips", "[parser]")
+{
+    for (std::size_t i = 0 ; i != sizeof(responses) / sizeof(responses[0])
+             ; ++i) {
+        check_folding<reader::response>(responses[i]);
+    }
+}
+
+TEST_CASE("Folding halves the tokens of a request", "[parser]")
+{
+    const std::string input = requests[0];
+    reader::request plain;
+    reader::request folding;
+    folding.set_skip_folding(true);
+
+    std::size_t ntokens = read_tokens(plain, input).size();
+    std::size_t nfolded = read_tokens(folding, input).size();
+    REQUIRE(nfolded * 3 < ntokens * 2);
+}
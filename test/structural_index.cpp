@@ -0,0 +1,156 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+#include <boost/http/reader/structural_index.hpp>
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static std::string many_fields_request()
+{
+    std::string ret = "GET /index.html?lang=en HTTP/1.1\r\n"
+        "Host: example.com\r\n";
+    for (int i = 0 ; i != 40 ; ++i) {
+        ret += "X-Field-";
+        ret += char('A' + i % 26);
+        ret += ": some value with\tspaces, commas; and=\"quotes\" \xA8\r\n";
+    }
+    ret += "Cookie: ";
+    ret.append(2000, 'c');
+    ret += "\r\n\r\n";
+    return ret;
+}
+
+static const char *requests[] = {
+    "GET / HTTP/1.1\r\n"
+    "host: aliceinthewonderland.com\t \r\n"
+    "\r\n"
+
+    "POST /upload HTTP/1.1\r\n"
+    "Content-length: 4\r\n"
+    "host:thelastringbearer.org\r\n"
+    "\r\n"
+    "ping"
+
+    "POST http://notheaven.onion/ HTTP/1.1\r\n"
+    "Host: playwithme.onion\r\n"
+    "X-Pants: On\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "4\r\n"
+    "Wiki\r\n"
+    "e\r\n"
+    " in\r\n\r\nchunks.\r\n"
+    "0\r\n"
+    "Content-MD5: \t  \t\t   25b83662323c397c9944a8a7b3fef7ab \t \r\n"
+    "\r\n"
+
+    "GET / HTTP/1.0\n"
+    "X-Lf-Only: yes\n"
+    "\n",
+
+    "GET / HTTP/1.1\r\n"
+    "Host: a\r\n"
+    "X-Bad Name: value\r\n"
+    "\r\n",
+
+    "GET / HTTP/1.1\r\n"
+    "Host: a\r\n"
+    "X-Bad-Value: val\x01ue\r\n"
+    "\r\n",
+
+    "GET / HTTP/1.1\r\n"
+    "Host: a\r\n"
+    "X-Bad-Line: value\rX\r\n"
+    "\r\n"
+};
+
+static const char *responses[] = {
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 5\r\n"
+    "X-Pants: On\r\n"
+    "\r\n"
+    "hello"
+
+    "HTTP/1.1 200 Still OK \t\xFF\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "3;ext=\"a\"\r\n"
+    "abc\r\n"
+    "0\r\n"
+    "Trailer-Name: trailer value\r\n"
+    "\r\n",
+
+    "HTTP/1.1 204 No Content\r\n"
+    "X-Bad:\x7F\r\n"
+    "\r\n"
+};
+
+template<class Parser>
+void check_same_tokens(const std::string &input)
+{
+    const std::size_t chunks[] = { 0, 1, 2, 3, 7, 64, 65, 200 };
+
+    for (std::size_t i = 0 ; i != sizeof(chunks) / sizeof(chunks[0]) ; ++i) {
+        Parser plain;
+        Parser indexed;
+        reader::structural_index index;
+        indexed.set_structural_index(&index);
+
+        INFO("chunk size " << chunks[i]);
+        std::vector<recorded_token> expected = read_tokens(plain, input,
+                                                         chunks[i]);
+        REQUIRE(read_tokens(indexed, input, chunks[i]) == expected);
+
+        // The index is reused after `reset()`
+        plain.reset();
+        indexed.reset();
+        REQUIRE(read_tokens(indexed, input) == read_tokens(plain, input));
+    }
+}
+
+TEST_CASE("Indexed request tokens", "[parser,index]")
+{
+    for (std::size_t i = 0 ; i != sizeof(requests) / sizeof(requests[0])
+             ; ++i) {
+        check_same_tokens<reader::request>(requests[i]);
+    }
+
+    check_same_tokens<reader::request>(many_fields_request());
+    check_same_tokens<reader::request>(many_fields_request()
+                                       + many_fields_request());
+}
+
+TEST_CASE("Indexed response tokens", "[parser,index]")
+{
+    for (std::size_t i = 0 ; i != sizeof(responses) / sizeof(responses[0])
+             ; ++i) {
+        check_same_tokens<reader::response>(responses[i]);
+    }
+}
+
+TEST_CASE("Index memory is reused", "[parser,index]")
+{
+    reader::request parser;
+    reader::structural_index index;
+    parser.set_structural_index(&index);
+
+    std::string input = many_fields_request();
+    parser.set_buffer(asio::buffer(input.data(), input.size()));
+    while (parser.code() != http::token::code::end_of_headers) {
+        REQUIRE(parser.code() != http::token::code::error_insufficient_data);
+        parser.next();
+    }
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::end_of_body);
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::end_of_message);
+    parser.next();
+    REQUIRE(parser.code() == http::token::code::error_insufficient_data);
+    REQUIRE(parser.parsed_count() == input.size());
+}
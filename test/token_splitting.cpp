@@ -0,0 +1,283 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+#include <boost/http/header_map.hpp>
+
+namespace http = boost::http;
+namespace reader = http::reader;
+
+using http::token::code;
+
+// A token as the application sees it, once its pieces are joined
+struct joined_token
+{
+    http::token::code::value kind;
+    std::string value;
+    // Number of pieces it came in
+    std::size_t npieces;
+};
+
+static std::string token_value(reader::request &parser)
+{
+    boost::string_view v;
+    switch (parser.code()) {
+    case code::request_target:
+        v = parser.value<http::token::request_target>();
+        break;
+    case code::field_value:
+        v = parser.value<http::token::field_value>();
+        break;
+    case code::trailer_value:
+        v = parser.value<http::token::trailer_value>();
+        break;
+    default:
+        return std::string();
+    }
+    return std::string(v.data(), v.size());
+}
+
+static std::string token_value(reader::response &parser)
+{
+    boost::string_view v;
+    switch (parser.code()) {
+    case code::field_value:
+        v = parser.value<http::token::field_value>();
+        break;
+    case code::trailer_value:
+        v = parser.value<http::token::trailer_value>();
+        break;
+    default:
+        return std::string();
+    }
+    return std::string(v.data(), v.size());
+}
+
+/* Reads `input` through a buffer that never holds more than `capacity` bytes
+   (parsed bytes are released after every round). Reading stops at the first
+   error or once the buffer is full of unparsed bytes. */
+template<class Parser>
+std::vector<joined_token> read_bounded(Parser &parser, const std::string &input,
+                                       std::size_t capacity)
+{
+    std::vector<joined_token> ret;
+    std::string buffer;
+    std::size_t fed = 0;
+    bool joining = false;
+
+    for (;;) {
+        std::size_t n = std::min(capacity - buffer.size(), input.size() - fed);
+        if (n == 0)
+            return ret;
+
+        buffer.append(input, fed, n);
+        fed += n;
+
+        parser.set_buffer(boost::asio::buffer(buffer.data(), buffer.size()));
+
+        while (parser.code() != code::error_insufficient_data) {
+            if (parser.symbol() == http::token::symbol::error) {
+                joined_token t = { parser.code(), std::string(), 1 };
+                ret.push_back(t);
+                return ret;
+            }
+
+            if (parser.code() != code::skip) {
+                if (joining) {
+                    REQUIRE(ret.back().kind == parser.code());
+                    ret.back().value += token_value(parser);
+                    ++ret.back().npieces;
+                } else {
+                    joined_token t = { parser.code(), token_value(parser), 1 };
+                    ret.push_back(t);
+                }
+                joining = !parser.final_piece();
+            }
+
+            prepare_token(parser);
+            parser.next();
+        }
+
+        buffer.erase(0, parser.parsed_count());
+    }
+}
+
+static std::string long_request(std::size_t cookie_size)
+{
+    std::string ret("GET /");
+    ret.append(300, 't');
+    ret.append(" HTTP/1.1\r\n"
+               "Host: example.com\r\n"
+               "Cookie: ");
+    for (std::size_t i = 0 ; i != cookie_size ; ++i)
+        ret += (i % 7 == 6) ? ' ' : char('a' + i % 26);
+    ret.append(" \t \r\n"
+               "Content-Length: 4\r\n"
+               "\r\n"
+               "Wiki");
+    return ret;
+}
+
+TEST_CASE("Oversized tokens fit small buffers", "[token_splitting]")
+{
+    std::string input = long_request(32 * 1024);
+
+    {
+        reader::request parser;
+        std::vector<joined_token> tokens = read_bounded(parser, input, 1024);
+        // Stalls on the cookie with a full buffer
+        REQUIRE(tokens.size() == 6);
+        REQUIRE(tokens.back().kind == code::field_name);
+    }
+
+    for (std::size_t capacity = 16 ; capacity <= 2048 ; capacity *= 2) {
+        reader::request parser;
+        parser.set_token_splitting(true);
+        std::vector<joined_token> tokens
+            = read_bounded(parser, input, capacity);
+        REQUIRE(tokens.back().kind == code::end_of_message);
+
+        reader::request whole;
+        std::vector<joined_token> expected = read_bounded(whole, input,
+                                                          input.size());
+        REQUIRE(tokens.size() == expected.size());
+        for (std::size_t i = 0 ; i != tokens.size() ; ++i) {
+            REQUIRE(tokens[i].kind == expected[i].kind);
+            REQUIRE(tokens[i].value == expected[i].value);
+        }
+
+        // request_target and the cookie
+        if (capacity < 300)
+            REQUIRE(tokens[1].npieces > 1);
+        REQUIRE(tokens[6].npieces > 1);
+        // Framing fields are never split
+        REQUIRE(tokens[8].value == "4");
+        REQUIRE(tokens[8].npieces == 1);
+    }
+}
+
+TEST_CASE("Trailing whitespace stays out of pieces", "[token_splitting]")
+{
+    std::string input("GET / HTTP/1.1\r\n"
+                      "Host: a\r\n"
+                      "X-Spaces: a  b \t c  \t \r\n"
+                      "\r\n");
+
+    // Field names aren't split, so the buffer must hold "X-Spaces:"
+    for (std::size_t capacity = 12 ; capacity != 40 ; ++capacity) {
+        reader::request parser;
+        parser.set_token_splitting(true);
+        std::vector<joined_token> tokens
+            = read_bounded(parser, input, capacity);
+        REQUIRE(tokens.back().kind == code::end_of_message);
+        REQUIRE(tokens[6].kind == code::field_value);
+        REQUIRE(tokens[6].value == "a  b \t c");
+    }
+}
+
+TEST_CASE("Split target limit", "[token_splitting]")
+{
+    std::string input = long_request(10);
+
+    reader::limits policy;
+    policy.max_target_size = 300;
+
+    reader::request parser;
+    parser.set_token_splitting(true);
+    parser.set_limits(&policy);
+    std::vector<joined_token> tokens = read_bounded(parser, input, 64);
+    REQUIRE(tokens.back().kind == code::error_request_target_too_long);
+
+    policy.max_target_size = 301;
+    reader::request other;
+    other.set_token_splitting(true);
+    other.set_limits(&policy);
+    tokens = read_bounded(other, input, 64);
+    REQUIRE(tokens.back().kind == code::end_of_message);
+}
+
+TEST_CASE("Split response values", "[token_splitting]")
+{
+    std::string value(5000, 'v');
+    std::string input("HTTP/1.1 200 OK\r\n"
+                      "Set-Cookie: " + value + "\r\n"
+                      "Transfer-Encoding: chunked\r\n"
+                      "\r\n"
+                      "0\r\n"
+                      "X-Trailer: " + value + "\r\n"
+                      "\r\n");
+
+    reader::response parser;
+    parser.set_token_splitting(true);
+    std::vector<joined_token> tokens = read_bounded(parser, input, 256);
+    REQUIRE(tokens.back().kind == code::end_of_message);
+
+    std::size_t nvalues = 0;
+    for (std::size_t i = 0 ; i != tokens.size() ; ++i) {
+        if (tokens[i].value == value) {
+            REQUIRE(tokens[i].npieces > 1);
+            ++nvalues;
+        }
+    }
+    REQUIRE(nvalues == 2);
+}
+
+TEST_CASE("Pieces are joined by the header containers", "[token_splitting]")
+{
+    std::string input("GET / HTTP/1.1\r\n"
+                      "Host: example.com\r\n"
+                      "Cookie: 0123456789abcdef \r\n"
+                      "\r\n");
+
+    for (std::size_t chunk = 1 ; chunk != 8 ; ++chunk) {
+        reader::message_view view;
+        http::header_map map;
+        reader::request parser;
+        parser.set_token_splitting(true);
+        parser.set_message_view(&view);
+
+        std::string buffer;
+        std::size_t parsed = 0;
+        std::size_t npieces = 0;
+        bool done = false;
+
+        for (std::size_t fed = 0 ; fed != input.size() && !done ;) {
+            std::size_t n = std::min(chunk, input.size() - fed);
+            buffer.append(input, fed, n);
+            fed += n;
+            parser.set_buffer(boost::asio::buffer(buffer.data() + parsed,
+                                                  buffer.size() - parsed));
+
+            while (parser.code() != code::error_insufficient_data) {
+                REQUIRE(parser.symbol() != http::token::symbol::error);
+                map.record(parser);
+
+                if (parser.code() == code::field_value)
+                    ++npieces;
+
+                if (parser.code() == code::end_of_headers) {
+                    REQUIRE(view.get(http::field_name_id::cookie)
+                            == "0123456789abcdef");
+                    REQUIRE(view.get(http::field_name_id::host)
+                            == "example.com");
+                    done = true;
+                    break;
+                }
+
+                parser.next();
+            }
+
+            parsed += parser.parsed_count();
+        }
+
+        REQUIRE(done);
+        REQUIRE(npieces > 2);
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.get("cookie") == "0123456789abcdef");
+        REQUIRE(map.get("host") == "example.com");
+    }
+}
@@ -0,0 +1,87 @@
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/response.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/* Helpers to compare the token streams that two differently configured readers
+   produce for the same input. */
+
+struct recorded_token
+{
+    bool operator==(const recorded_token &o) const
+    {
+        return code == o.code && size == o.size && offset == o.offset;
+    }
+
+    boost::http::token::code::value code;
+    std::size_t size;
+    // Position of the token relative to the whole input
+    std::size_t offset;
+};
+
+inline std::ostream &operator<<(std::ostream &os, const recorded_token &t)
+{
+    return os << '{' << Catch::toString(t.code) << ", " << t.size << ", "
+              << t.offset << '}';
+}
+
+template<class Policy>
+void prepare_token(boost::http::reader::basic_request<Policy> &)
+{}
+
+template<class Policy>
+void prepare_token(boost::http::reader::basic_response<Policy> &parser)
+{
+    if (parser.code() == boost::http::token::code::status_code)
+        parser.set_method("GET");
+}
+
+/* Feeds `input` to `parser`, `chunk` bytes at a time (0 means everything at
+   once), and releases the parsed bytes from the head of the buffer after every
+   round as a real application would. */
+template<class Parser>
+std::vector<recorded_token> read_tokens(Parser &parser, const std::string &input,
+                                      std::size_t chunk = 0)
+{
+    using boost::http::token::code;
+    using boost::http::token::category;
+
+    std::vector<recorded_token> ret;
+    std::string buffer;
+    std::size_t released = 0;
+    std::size_t fed = 0;
+
+    if (chunk == 0)
+        chunk = input.size();
+
+    while (fed != input.size()) {
+        std::size_t n = std::min(chunk, input.size() - fed);
+        buffer.append(input, fed, n);
+        fed += n;
+
+        parser.set_buffer(boost::asio::buffer(buffer.data(), buffer.size()));
+
+        while (parser.code() != code::error_insufficient_data) {
+            recorded_token t = {
+                parser.code(),
+                parser.token_size(),
+                released + parser.parsed_count()
+            };
+            ret.push_back(t);
+
+            if (parser.category() == category::status
+                && parser.code() != code::skip) {
+                return ret;
+            }
+
+            prepare_token(parser);
+            parser.next();
+        }
+
+        released += parser.parsed_count();
+        buffer.erase(0, parser.parsed_count());
+    }
+
+    return ret;
+}
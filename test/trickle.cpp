@@ -0,0 +1,97 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include "tokens.hpp"
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+namespace reader = http::reader;
+
+static const char request_input[] =
+    "POST /upload HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "X-Some-Long-Field-Name: a value with spaces, commas and \xA8\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "000000004\r\n"
+    "Wiki\r\n"
+    "0\r\n"
+    "Some-Trailer: and its value\r\n"
+    "\r\n";
+
+static const char response_input[] =
+    "HTTP/1.1 200 A quite long reason phrase\r\n"
+    "Content-Length: 4\r\n"
+    "X-Some-Long-Field-Name: a value with spaces\r\n"
+    "\r\n"
+    "body";
+
+// Skip tokens and body chunks depend on how the input is split
+static std::vector<recorded_token> data_tokens(std::vector<recorded_token> in)
+{
+    std::vector<recorded_token> ret;
+    for (std::size_t i = 0 ; i != in.size() ; ++i) {
+        if (in[i].code != http::token::code::skip
+            && in[i].code != http::token::code::body_chunk) {
+            ret.push_back(in[i]);
+        }
+    }
+    return ret;
+}
+
+template<class Parser>
+void check_trickled(const std::string &input)
+{
+    Parser whole;
+    Parser trickled;
+
+    std::vector<recorded_token> expected = data_tokens(read_tokens(whole,
+                                                                 input));
+    REQUIRE(!expected.empty());
+    REQUIRE(data_tokens(read_tokens(trickled, input, 1)) == expected);
+}
+
+TEST_CASE("Trickled input yields the same tokens", "[parser]")
+{
+    check_trickled<reader::request>(request_input);
+    check_trickled<reader::response>(response_input);
+}
+
+/* `token_size()` reports the bytes already matched of a partial token, which
+   is what allows resuming without rescanning them. */
+TEST_CASE("Partial tokens are resumed", "[parser]")
+{
+    const std::string input = "GET / HTTP/1.1\r\n"
+        "Host: a\r\n"
+        "X-Long-Name: long value\r\n";
+    const std::size_t name_begin = input.find("X-Long");
+    const std::size_t value_begin = input.find("long value");
+    const std::size_t value_end = input.size() - 2;
+
+    reader::request parser;
+    std::size_t released = 0;
+    std::size_t nchecked = 0;
+
+    for (std::size_t end = 1 ; end <= input.size() ; ++end) {
+        parser.set_buffer(asio::buffer(input.data() + released,
+                                       end - released));
+        while (parser.code() != http::token::code::error_insufficient_data)
+            parser.next();
+
+        std::size_t begin = released + parser.parsed_count();
+        if ((begin == name_begin && end < value_begin - 2)
+            || (begin == value_begin && end < value_end)) {
+            REQUIRE(parser.token_size() == end - begin);
+            ++nchecked;
+        }
+
+        released += parser.parsed_count();
+    }
+
+    // Every split within the field name and within the field value
+    REQUIRE(nchecked == (value_begin - 2 - name_begin)
+            + (value_end - value_begin));
+}